@@ -1,6 +1,6 @@
 "use client";
 
-import { useState } from "react";
+import { useEffect, useState } from "react";
 import { useRouter } from "next/navigation";
 import { Upload, Play, Loader2 } from "lucide-react";
 import { Button } from "@/components/ui/button";
@@ -13,7 +13,7 @@ import {
 } from "@/components/ui/dialog";
 import { CSVUpload } from "@/components/shared/csv-upload";
 import { DataPreview } from "@/components/shared/data-preview";
-import { rerunPipeline } from "@/lib/api";
+import { rerunPipeline, previewPipeline } from "@/lib/api";
 import type { ParsedCSV } from "@/lib/types";
 
 interface RerunModalProps {
@@ -36,6 +36,31 @@ export function RerunModal({
   const [parsedData, setParsedData] = useState<ParsedCSV | null>(null);
   const [isRunning, setIsRunning] = useState(false);
   const [error, setError] = useState<string | null>(null);
+  const [outputPreview, setOutputPreview] = useState<ParsedCSV | null>(null);
+
+  // Preview the recipe's first output rows as soon as a file is chosen
+  useEffect(() => {
+    if (!csvContent) return;
+    let cancelled = false;
+
+    previewPipeline(
+      pipelineId,
+      pipelineVersionId,
+      { format: "csv", content_base64: btoa(csvContent) },
+      { limit: 5 }
+    )
+      .then((result) => {
+        if (!cancelled) setOutputPreview(result.output);
+      })
+      .catch((err) => {
+        // The preview is informational; running still reports real errors
+        console.error("Preview failed:", err);
+      });
+
+    return () => {
+      cancelled = true;
+    };
+  }, [csvContent, pipelineId, pipelineVersionId]);
 
   const handleDataParsed = (parsed: ParsedCSV, content: string) => {
     setCsvContent(content);
@@ -46,6 +71,7 @@ export function RerunModal({
   const handleClear = () => {
     setCsvContent("");
     setParsedData(null);
+    setOutputPreview(null);
     setError(null);
   };
 
@@ -123,6 +149,16 @@ export function RerunModal({
               <div className="overflow-hidden rounded-lg border">
                 <DataPreview data={parsedData} maxRows={5} className="max-h-[280px]" />
               </div>
+
+              {/* Output preview from the engine */}
+              {outputPreview && (
+                <div className="space-y-2 overflow-hidden">
+                  <p className="text-sm text-muted-foreground">Output preview</p>
+                  <div className="overflow-hidden rounded-lg border">
+                    <DataPreview data={outputPreview} maxRows={5} className="max-h-[280px]" />
+                  </div>
+                </div>
+              )}
             </div>
           )}
 
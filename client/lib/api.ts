@@ -4,6 +4,7 @@ import type {
   Run, 
   CreatePipelineRequest, 
   CreatePipelineResponse,
+  ParsedCSV,
 } from "./types";
 
 // API Base URL - defaults to local server
@@ -273,6 +274,32 @@ export async function rerunPipeline(
   });
 }
 
+// ============================================
+// Preview Pipeline
+// ============================================
+
+interface PreviewResponse {
+  output: ParsedCSV;
+  exec_time_ms: number;
+}
+
+// First output rows of a saved version on new data (nothing is recorded)
+export async function previewPipeline(
+  pipelineId: string,
+  pipelineVersionId: string,
+  data: { format: "csv"; content_base64: string },
+  options?: { limit?: number; mode?: "head" | "sample"; seed?: number }
+): Promise<PreviewResponse> {
+  return fetchAPI<PreviewResponse>(`/pipelines/${pipelineId}/preview`, {
+    method: "POST",
+    body: JSON.stringify({
+      pipeline_version_id: pipelineVersionId,
+      data,
+      options,
+    }),
+  });
+}
+
 // ============================================
 // Export Docker
 // ============================================
@@ -2,13 +2,14 @@
 // WASM Engine Bindings
 // ============================================
 
-import type { PipelineSpec, ParsedCSV, ValidationResult } from "../src/lib/types";
+import type { PipelineSpec, ParsedCSV, ValidationResult, EngineRunStats } from "../src/lib/types";
 import { parseCSV, serializeCSV } from "../src/lib/csv";
 
 // TypeScript fallback implementations
 import {
   validatePipeline as tsValidate,
   runPipeline as tsRun,
+  computeColumnStats as tsColumnStats,
 } from "../src/lib/wasm-engine";
 
 // ============================================
@@ -17,13 +18,96 @@ import {
 
 interface WasmModule {
   _validate_pipeline: (specPtr: number) => number;
-  _run_pipeline: (specPtr: number, csvPtr: number) => number;
+  _run_pipeline: (specPtr: number, inputPtr: number, inputSize: number) => number;
+  _run_pipeline_compressed: (
+    specPtr: number,
+    inputPtr: number,
+    inputSize: number,
+    inputCodecPtr: number,
+    outputCodecPtr: number,
+    outputSizePtr: number
+  ) => number;
+  _preview_pipeline: (specPtr: number, inputPtr: number, inputSize: number, optionsPtr: number) => number;
+  _batch_open: (specPtr: number) => number;
+  _batch_run: (handle: number, inputPtr: number, inputSize: number) => number;
+  _batch_close: (handle: number) => void;
+  _engine_create: () => number;
+  _engine_destroy: (ctx: number) => void;
+  _engine_input_buffer: (ctx: number, size: number) => number;
+  _engine_run: (
+    ctx: number,
+    specPtr: number,
+    inputPtr: number,
+    inputSize: number,
+    collectStats: number
+  ) => number;
+  _engine_run_snapshotting: (
+    ctx: number,
+    specPtr: number,
+    inputPtr: number,
+    inputSize: number,
+    collectStats: number
+  ) => number;
+  _engine_last_snapshot: (ctx: number, outputSizePtr: number) => number;
+  _engine_last_stats: (ctx: number) => number;
+  _engine_preview: (
+    ctx: number,
+    specPtr: number,
+    inputPtr: number,
+    inputSize: number,
+    optionsPtr: number
+  ) => number;
+  _engine_snapshot: (ctx: number, inputPtr: number, inputSize: number, outputSizePtr: number) => number;
   _free_result: (ptr: number) => void;
   _malloc: (size: number) => number;
   _free: (ptr: number) => void;
   UTF8ToString: (ptr: number) => string;
   stringToUTF8: (str: string, ptr: number, maxBytes: number) => void;
   lengthBytesUTF8: (str: string) => number;
+  getValue: (ptr: number, type: string) => number;
+  HEAPU8: Uint8Array;
+}
+
+export type CompressionCodec = "none" | "gzip" | "zstd";
+
+export interface PreviewOptions {
+  limit?: number;
+  mode?: "head" | "sample";
+  seed?: number;
+}
+
+export interface RunWithStatsResult {
+  output: ParsedCSV;
+  stats: EngineRunStats;
+  snapshot?: Uint8Array; // the run's input as a snapshot, when requested
+}
+
+// Pipeline input: parsed rows, raw CSV text, or snapshot bytes
+export type EngineInput = ParsedCSV | string | Uint8Array;
+
+// One input's outcome in a batch run (CSV text in and out)
+export type BatchResult = { output: string } | { error: string };
+
+// Messages exchanged with pool workers (engine-worker.ts)
+export type EngineRequest =
+  | { id: number; kind: "run"; spec: PipelineSpec; input: EngineInput; snapshot?: boolean }
+  | { id: number; kind: "preview"; spec: PipelineSpec; input: string | Uint8Array; options: PreviewOptions }
+  | { id: number; kind: "snapshot"; csv: string }
+  | { id: number; kind: "batch"; spec: PipelineSpec; inputs: (string | Uint8Array)[] };
+
+export type EngineResponse =
+  | { id: number; result: RunWithStatsResult | ParsedCSV | Uint8Array | BatchResult[] | null }
+  | { id: number; error: string };
+
+// Shape of a dataset stored in a snapshot
+export interface SnapshotInfo {
+  headers: string[];
+  rows: number;
+}
+
+export interface CompressionOptions {
+  inputCodec?: CompressionCodec | "auto";
+  outputCodec?: CompressionCodec;
 }
 
 // ============================================
@@ -32,6 +116,8 @@ interface WasmModule {
 
 let wasmModule: WasmModule | null = null;
 let useWasm = false;
+// Engine context owning this instance's result and input buffers
+let engineContext = 0;
 
 // ============================================
 // WASM Loading
@@ -42,7 +128,9 @@ export async function loadWasmEngine(): Promise<boolean> {
     // Dynamic import of the Emscripten-generated module
     // This will be available after building with `make`
     const createModule = await import("./build/pipeline_engine.js");
-    wasmModule = await createModule.default();
+    const module: WasmModule = await createModule.default();
+    engineContext = module._engine_create();
+    wasmModule = module;
     useWasm = true;
     console.log("WASM engine loaded successfully");
     return true;
@@ -68,6 +156,37 @@ function allocateString(wasm: WasmModule, str: string): number {
   return ptr;
 }
 
+function allocateBytes(wasm: WasmModule, bytes: Uint8Array): number {
+  const ptr = wasm._malloc(Math.max(bytes.length, 1));
+  wasm.HEAPU8.set(bytes, ptr);
+  return ptr;
+}
+
+// Snapshot magic: "\x89PSNAP\0" followed by the format version
+const SNAPSHOT_MAGIC = [0x89, 0x50, 0x53, 0x4e, 0x41, 0x50, 0x00];
+
+export function isSnapshot(bytes: Uint8Array): boolean {
+  return bytes.length >= 8 && SNAPSHOT_MAGIC.every((b, i) => bytes[i] === b);
+}
+
+// Copy input bytes into the engine context's reusable input buffer
+function stageInput(wasm: WasmModule, input: string | Uint8Array): { ptr: number; size: number } {
+  if (typeof input === "string") {
+    const size = wasm.lengthBytesUTF8(input);
+    const ptr = wasm._engine_input_buffer(engineContext, size);
+    wasm.stringToUTF8(input, ptr, size + 1);
+    return { ptr, size };
+  }
+  const ptr = wasm._engine_input_buffer(engineContext, input.length);
+  // Read HEAPU8 after the call; the buffer may have grown memory
+  wasm.HEAPU8.set(input, ptr);
+  return { ptr, size: input.length };
+}
+
+function isGzip(bytes: Uint8Array): boolean {
+  return bytes.length >= 2 && bytes[0] === 0x1f && bytes[1] === 0x8b;
+}
+
 // ============================================
 // Exported Functions
 // ============================================
@@ -105,8 +224,9 @@ export function runPipeline(spec: PipelineSpec, inputCSV: ParsedCSV): ParsedCSV
       
       const specPtr = allocateString(wasmModule, specJson);
       const csvPtr = allocateString(wasmModule, csvString);
+      const csvBytes = wasmModule.lengthBytesUTF8(csvString);
       
-      const resultPtr = wasmModule._run_pipeline(specPtr, csvPtr);
+      const resultPtr = wasmModule._run_pipeline(specPtr, csvPtr, csvBytes);
       const resultString = wasmModule.UTF8ToString(resultPtr);
       
       // Free allocated memory
@@ -130,3 +250,498 @@ export function runPipeline(spec: PipelineSpec, inputCSV: ParsedCSV): ParsedCSV
   // Fallback to TypeScript implementation
   return tsRun(spec, inputCSV);
 }
+
+// With snapshot set, the engine also encodes the input it parsed for this
+// run as a snapshot (WASM only), so callers can cache it without parsing
+// the same data twice
+export function runPipelineWithStats(
+  spec: PipelineSpec,
+  input: EngineInput,
+  options: { snapshot?: boolean } = {}
+): RunWithStatsResult {
+  // Use WASM if available: column statistics are gathered while the
+  // output is serialized, so no extra pass over the cells is needed.
+  // Snapshots (see createSnapshot) are loaded without parsing.
+  if (useWasm && wasmModule) {
+    try {
+      const wasm = wasmModule;
+      const specPtr = allocateString(wasm, JSON.stringify(spec));
+      const staged = stageInput(wasm, typeof input === "string" || input instanceof Uint8Array ? input : serializeCSV(input));
+
+      // Result and stats are owned by the context: copy them out, don't free
+      const run = options.snapshot ? wasm._engine_run_snapshotting : wasm._engine_run;
+      const resultString = wasm.UTF8ToString(run(engineContext, specPtr, staged.ptr, staged.size, 1));
+      wasm._free(specPtr);
+
+      // Check if result is an error JSON
+      if (resultString.startsWith('{"error":')) {
+        const error = JSON.parse(resultString);
+        throw new Error(error.message);
+      }
+
+      const statsJson = wasm.UTF8ToString(wasm._engine_last_stats(engineContext));
+      const result: RunWithStatsResult = {
+        output: parseCSV(resultString),
+        stats: JSON.parse(statsJson) as EngineRunStats,
+      };
+      if (options.snapshot) {
+        const sizePtr = wasm._malloc(4);
+        const snapshotPtr = wasm._engine_last_snapshot(engineContext, sizePtr);
+        const snapshotSize = wasm.getValue(sizePtr, "i32");
+        result.snapshot = wasm.HEAPU8.slice(snapshotPtr, snapshotPtr + snapshotSize);
+        wasm._free(sizePtr);
+      }
+      return result;
+    } catch (error) {
+      // The TS engine can't read snapshots: report the engine's own error
+      if (input instanceof Uint8Array) {
+        throw error;
+      }
+      console.error("WASM execution failed, falling back to TS:", error);
+    }
+  }
+
+  if (input instanceof Uint8Array) {
+    throw new Error("Snapshots can only be run by the WASM engine");
+  }
+  const inputCSV = typeof input === "string" ? parseCSV(input) : input;
+
+  // Fallback to TypeScript implementation (no per-node timings, filters
+  // run in spec order)
+  const output = tsRun(spec, inputCSV);
+  return {
+    output,
+    stats: {
+      nodes: [],
+      input_rows: inputCSV.rows.length,
+      output_rows: output.rows.length,
+      columns: tsColumnStats(output),
+      filter_order: [],
+    },
+  };
+}
+
+// Preview takes the raw CSV text (or bytes) so the engine can stop parsing
+// as soon as enough output rows exist
+export function previewPipeline(
+  spec: PipelineSpec,
+  input: string | Uint8Array,
+  options: PreviewOptions = {}
+): ParsedCSV {
+  const limit = options.limit ?? 100;
+
+  // Use WASM if available: parsing stops as soon as the preview is full
+  if (useWasm && wasmModule) {
+    try {
+      const wasm = wasmModule;
+      const specPtr = allocateString(wasm, JSON.stringify(spec));
+      const optionsPtr = allocateString(wasm, JSON.stringify({ ...options, limit }));
+      const staged = stageInput(wasm, input);
+
+      // Result is owned by the context: copy it out, don't free
+      const resultString = wasm.UTF8ToString(
+        wasm._engine_preview(engineContext, specPtr, staged.ptr, staged.size, optionsPtr)
+      );
+      wasm._free(specPtr);
+      wasm._free(optionsPtr);
+
+      // Check if result is an error JSON
+      if (resultString.startsWith('{"error":')) {
+        const error = JSON.parse(resultString);
+        throw new Error(error.message);
+      }
+
+      return parseCSV(resultString);
+    } catch (error) {
+      // The TS engine can't read snapshots: report the engine's own error
+      if (input instanceof Uint8Array && isSnapshot(input)) {
+        throw error;
+      }
+      console.error("WASM preview failed, falling back to TS:", error);
+    }
+  }
+
+  // Fallback to TypeScript implementation (head only, full parse)
+  if (input instanceof Uint8Array && isSnapshot(input)) {
+    throw new Error("Snapshots can only be previewed by the WASM engine");
+  }
+  const csvText = typeof input === "string" ? input : new TextDecoder().decode(input);
+  const output = tsRun(spec, parseCSV(csvText));
+  return { headers: output.headers, rows: output.rows.slice(0, limit) };
+}
+
+export function runPipelineCompressed(
+  spec: PipelineSpec,
+  input: Uint8Array,
+  options: CompressionOptions = {}
+): Uint8Array {
+  const inputCodec = options.inputCodec ?? "auto";
+  const outputCodec = options.outputCodec ?? "none";
+
+  // Use WASM if available: input is inflated while it is parsed and the
+  // output is compressed while it is serialized
+  if (useWasm && wasmModule) {
+    try {
+      const specPtr = allocateString(wasmModule, JSON.stringify(spec));
+      const inputPtr = allocateBytes(wasmModule, input);
+      const inCodecPtr = allocateString(wasmModule, inputCodec);
+      const outCodecPtr = allocateString(wasmModule, outputCodec);
+      const sizePtr = wasmModule._malloc(4);
+
+      const resultPtr = wasmModule._run_pipeline_compressed(
+        specPtr,
+        inputPtr,
+        input.length,
+        inCodecPtr,
+        outCodecPtr,
+        sizePtr
+      );
+      const resultSize = wasmModule.getValue(sizePtr, "i32");
+      // Copy out before freeing; HEAPU8 may be replaced on memory growth
+      const result = wasmModule.HEAPU8.slice(resultPtr, resultPtr + resultSize);
+
+      // Free allocated memory
+      wasmModule._free(specPtr);
+      wasmModule._free(inputPtr);
+      wasmModule._free(inCodecPtr);
+      wasmModule._free(outCodecPtr);
+      wasmModule._free(sizePtr);
+      wasmModule._free_result(resultPtr);
+
+      // Check if result is an error JSON
+      const head = new TextDecoder().decode(result.subarray(0, 9));
+      if (head === '{"error":') {
+        const error = JSON.parse(new TextDecoder().decode(result));
+        throw new Error(error.message);
+      }
+
+      return result;
+    } catch (error) {
+      console.error("WASM execution failed, falling back to TS:", error);
+    }
+  }
+
+  // Fallback to TypeScript implementation (gzip only)
+  if (inputCodec === "zstd" || outputCodec === "zstd") {
+    throw new Error("zstd is only supported by the WASM engine");
+  }
+  const gzipped = inputCodec === "gzip" || (inputCodec === "auto" && isGzip(input));
+  const csvText = new TextDecoder().decode(gzipped ? Bun.gunzipSync(input) : input);
+  const outputText = serializeCSV(tsRun(spec, parseCSV(csvText)));
+  const outputBytes = new TextEncoder().encode(outputText);
+  return outputCodec === "gzip" ? Bun.gzipSync(outputBytes) : outputBytes;
+}
+
+// Run one pipeline over many CSV inputs (text, or bytes such as snapshots).
+// The engine parses the spec and compiles its operators once for the whole
+// batch; each result is yielded as soon as its input finishes. Failures are
+// reported per input.
+export function* runPipelineBatch(
+  spec: PipelineSpec,
+  inputs: Iterable<string | Uint8Array>
+): Generator<BatchResult> {
+  const iterator = inputs[Symbol.iterator]();
+
+  // Use WASM if available
+  if (useWasm && wasmModule) {
+    const wasm = wasmModule;
+    let handle = 0;
+    try {
+      const specPtr = allocateString(wasm, JSON.stringify(spec));
+      handle = wasm._batch_open(specPtr);
+      wasm._free(specPtr);
+    } catch (error) {
+      console.error("WASM batch failed, falling back to TS:", error);
+    }
+
+    if (handle) {
+      try {
+        for (let next = iterator.next(); !next.done; next = iterator.next()) {
+          const input = next.value;
+          const inputPtr = typeof input === "string" ? allocateString(wasm, input) : allocateBytes(wasm, input);
+          const inputSize = typeof input === "string" ? wasm.lengthBytesUTF8(input) : input.length;
+          // The result buffer belongs to the batch; copy it out before the next run
+          const resultString = wasm.UTF8ToString(wasm._batch_run(handle, inputPtr, inputSize));
+          wasm._free(inputPtr);
+
+          if (resultString.startsWith('{"error":')) {
+            yield { error: JSON.parse(resultString).message as string };
+          } else {
+            yield { output: resultString };
+          }
+        }
+      } finally {
+        wasm._batch_close(handle);
+      }
+      return;
+    }
+  }
+
+  // Fallback to TypeScript implementation
+  for (let next = iterator.next(); !next.done; next = iterator.next()) {
+    let result: BatchResult;
+    try {
+      const input = next.value;
+      if (input instanceof Uint8Array && isSnapshot(input)) {
+        throw new Error("Snapshots can only be run by the WASM engine");
+      }
+      const csvText = typeof input === "string" ? input : new TextDecoder().decode(input);
+      result = { output: serializeCSV(tsRun(spec, parseCSV(csvText))) };
+    } catch (error) {
+      result = { error: error instanceof Error ? error.message : String(error) };
+    }
+    yield result;
+  }
+}
+
+// ============================================
+// Snapshots
+// ============================================
+
+// Encode CSV text as a columnar snapshot that runPipelineWithStats accepts
+// in place of the CSV, so reruns on the same data skip parsing.
+// Returns null when the WASM engine is unavailable.
+export function createSnapshot(csvText: string): Uint8Array | null {
+  if (!useWasm || !wasmModule) {
+    return null;
+  }
+
+  try {
+    const wasm = wasmModule;
+    const staged = stageInput(wasm, csvText);
+    const sizePtr = wasm._malloc(4);
+
+    const resultPtr = wasm._engine_snapshot(engineContext, staged.ptr, staged.size, sizePtr);
+    const resultSize = wasm.getValue(sizePtr, "i32");
+    // Owned by the context: copy out before the next call
+    const result = wasm.HEAPU8.slice(resultPtr, resultPtr + resultSize);
+    wasm._free(sizePtr);
+
+    if (!isSnapshot(result)) {
+      const error = JSON.parse(new TextDecoder().decode(result));
+      throw new Error(error.message);
+    }
+    return result;
+  } catch (error) {
+    console.error("WASM snapshot failed:", error);
+    return null;
+  }
+}
+
+// Read the headers and row count from a snapshot's header
+export function snapshotInfo(snapshot: Uint8Array): SnapshotInfo {
+  if (!isSnapshot(snapshot)) {
+    throw new Error("Not a pipeline snapshot");
+  }
+  const view = new DataView(snapshot.buffer, snapshot.byteOffset, snapshot.byteLength);
+  const headerCount = view.getUint32(8, true);
+  const rows = Number(view.getBigUint64(16, true));
+
+  const decoder = new TextDecoder();
+  const headers: string[] = [];
+  let offset = 32;
+  for (let i = 0; i < headerCount; i++) {
+    const length = view.getUint32(offset, true);
+    headers.push(decoder.decode(snapshot.subarray(offset + 4, offset + 4 + length)));
+    offset += 4 + length;
+  }
+
+  return { headers, rows };
+}
+
+// ============================================
+// Worker Pool
+// ============================================
+// Each worker hosts its own module instance and engine context, so
+// concurrent requests run in parallel instead of queueing behind one
+// synchronous call on the event loop.
+
+type WithoutId<T> = T extends unknown ? Omit<T, "id"> : never;
+
+interface PoolWorker {
+  worker: Worker;
+  inFlight: number;
+  ready: boolean; // loaded the engine
+}
+
+interface PendingRequest {
+  worker: PoolWorker;
+  resolve: (result: unknown) => void;
+  reject: (error: Error) => void;
+}
+
+class EnginePool {
+  private workers: PoolWorker[] = [];
+  private pending = new Map<number, PendingRequest>();
+  private nextId = 1;
+  private started = false;
+  private stopped = false;
+
+  // Resolves once every worker has loaded the engine, or null if any failed
+  static async start(size: number): Promise<EnginePool | null> {
+    const pool = new EnginePool();
+    const loaded = await Promise.all(Array.from({ length: size }, () => pool.spawn()));
+    if (loaded.every(Boolean)) {
+      pool.started = true;
+      return pool;
+    }
+    pool.terminate();
+    return null;
+  }
+
+  get size(): number {
+    return this.workers.length;
+  }
+
+  request<T>(message: WithoutId<EngineRequest>): Promise<T> {
+    if (this.workers.length === 0) {
+      return Promise.reject(new Error("Engine pool has no workers"));
+    }
+
+    // Dispatch to the least busy worker
+    const target = this.workers.reduce((best, w) => (w.inFlight < best.inFlight ? w : best));
+    const id = this.nextId++;
+
+    return new Promise<T>((resolve, reject) => {
+      this.pending.set(id, { worker: target, resolve: resolve as (result: unknown) => void, reject });
+      target.inFlight++;
+      target.worker.postMessage({ ...message, id } as EngineRequest);
+    });
+  }
+
+  terminate(): void {
+    this.stopped = true;
+    for (const entry of [...this.workers]) {
+      this.remove(entry, new Error("Engine pool stopped"));
+    }
+  }
+
+  private spawn(): Promise<boolean> {
+    return new Promise<boolean>((resolve) => {
+      const worker = new Worker(new URL("./engine-worker.ts", import.meta.url).href);
+      const entry: PoolWorker = { worker, inFlight: 0, ready: false };
+      this.workers.push(entry);
+
+      worker.onmessage = (event: MessageEvent<EngineResponse | { ready: boolean }>) => {
+        const message = event.data;
+        if ("ready" in message) {
+          entry.ready = message.ready;
+          // A replacement that can't load the engine leaves the pool
+          if (!message.ready && this.started) {
+            this.remove(entry, new Error("Engine worker could not load the engine"));
+          }
+          resolve(message.ready);
+          return;
+        }
+        this.settle(entry, message);
+      };
+      worker.onerror = (event: ErrorEvent) => {
+        console.error("Engine worker failed:", event.message);
+        this.remove(entry, new Error(`Engine worker failed: ${event.message}`));
+        resolve(false);
+
+        // Replace workers that die while serving so the pool keeps its
+        // size; one that never loaded is not retried
+        if (entry.ready && this.started && !this.stopped) {
+          this.spawn();
+        }
+      };
+    });
+  }
+
+  private settle(entry: PoolWorker, response: EngineResponse): void {
+    const request = this.pending.get(response.id);
+    if (!request) return;
+    this.pending.delete(response.id);
+    entry.inFlight--;
+
+    if ("error" in response) {
+      request.reject(new Error(response.error));
+    } else {
+      request.resolve(response.result);
+    }
+  }
+
+  // Drop a worker from rotation, failing anything still queued on it
+  private remove(entry: PoolWorker, error: Error): void {
+    this.workers = this.workers.filter((w) => w !== entry);
+    entry.worker.terminate();
+    for (const [id, request] of this.pending) {
+      if (request.worker === entry) {
+        this.pending.delete(id);
+        request.reject(error);
+      }
+    }
+    if (this.workers.length === 0 && this.started && !this.stopped) {
+      console.error("Engine pool has no workers left; engine calls now fail");
+    }
+  }
+}
+
+let enginePool: EnginePool | null = null;
+
+export async function startEnginePool(
+  size = Number(process.env.ENGINE_POOL_SIZE) || Math.min(4, navigator.hardwareConcurrency || 1)
+): Promise<boolean> {
+  stopEnginePool();
+  try {
+    enginePool = await EnginePool.start(size);
+  } catch (error) {
+    console.log("Engine worker pool not available:", error);
+    enginePool = null;
+  }
+  return enginePool !== null;
+}
+
+export function stopEnginePool(): void {
+  enginePool?.terminate();
+  enginePool = null;
+}
+
+export function enginePoolSize(): number {
+  return enginePool?.size ?? 0;
+}
+
+// Pooled variant of runPipelineWithStats; runs inline without a pool
+export function runPipelineWithStatsAsync(
+  spec: PipelineSpec,
+  input: EngineInput,
+  options: { snapshot?: boolean } = {}
+): Promise<RunWithStatsResult> {
+  if (enginePool) {
+    return enginePool.request<RunWithStatsResult>({ kind: "run", spec, input, snapshot: options.snapshot });
+  }
+  return Promise.resolve(runPipelineWithStats(spec, input, options));
+}
+
+// Pooled variant of runPipelineBatch, collecting every result; the whole
+// batch runs on one worker. Runs inline without a pool
+export function runPipelineBatchAsync(
+  spec: PipelineSpec,
+  inputs: (string | Uint8Array)[]
+): Promise<BatchResult[]> {
+  if (enginePool) {
+    return enginePool.request<BatchResult[]>({ kind: "batch", spec, inputs });
+  }
+  return Promise.resolve([...runPipelineBatch(spec, inputs)]);
+}
+
+// Pooled variant of createSnapshot; runs inline without a pool
+export function createSnapshotAsync(csvText: string): Promise<Uint8Array | null> {
+  if (enginePool) {
+    return enginePool.request<Uint8Array | null>({ kind: "snapshot", csv: csvText });
+  }
+  return Promise.resolve(createSnapshot(csvText));
+}
+
+// Pooled variant of previewPipeline; runs inline without a pool
+export function previewPipelineAsync(
+  spec: PipelineSpec,
+  input: string | Uint8Array,
+  options: PreviewOptions = {}
+): Promise<ParsedCSV> {
+  if (enginePool) {
+    return enginePool.request<ParsedCSV>({ kind: "preview", spec, input, options });
+  }
+  return Promise.resolve(previewPipeline(spec, input, options));
+}
@@ -0,0 +1,43 @@
+// ============================================
+// Engine Worker
+// ============================================
+// Hosts one engine module instance (with its own engine context) for the
+// pool in bindings.ts. Requests are handled one at a time.
+
+import {
+  loadWasmEngine,
+  runPipelineWithStats,
+  previewPipeline,
+  runPipelineBatch,
+  createSnapshot,
+  type EngineRequest,
+  type EngineResponse,
+} from "./bindings";
+
+declare var self: Worker;
+
+const ready = loadWasmEngine();
+
+self.onmessage = async (event: MessageEvent<EngineRequest>) => {
+  const request = event.data;
+  await ready;
+
+  let response: EngineResponse;
+  try {
+    const result =
+      request.kind === "run"
+        ? runPipelineWithStats(request.spec, request.input, { snapshot: request.snapshot })
+        : request.kind === "preview"
+          ? previewPipeline(request.spec, request.input, request.options)
+          : request.kind === "batch"
+            ? [...runPipelineBatch(request.spec, request.inputs)]
+            : createSnapshot(request.csv);
+    response = { id: request.id, result };
+  } catch (error) {
+    response = { id: request.id, error: error instanceof Error ? error.message : String(error) };
+  }
+  self.postMessage(response);
+};
+
+// Report whether this instance loaded the WASM engine
+ready.then((loaded) => self.postMessage({ ready: loaded }));
@@ -0,0 +1,414 @@
+// Native command-line runner for exported pipelines
+// Usage: pipeline_cli <spec.json> <input.csv> [options]
+//        pipeline_cli <spec.json> <input.csv>... --output-dir <dir> [options]
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "types.h"
+#include "validator.h"
+#include "executor.h"
+#include "csv_parser.h"
+#include "compression.h"
+#include "snapshot.h"
+
+using namespace pipeline;
+
+// Upper bound for --threads
+static const unsigned MAX_THREADS = 256;
+
+// Parse a --threads value: decimal digits only, 1..MAX_THREADS
+static bool parse_thread_count(const std::string& value, unsigned& threads) {
+    if (value.empty() || value.size() > 3) return false;
+    unsigned parsed = 0;
+    for (char c : value) {
+        if (c < '0' || c > '9') return false;
+        parsed = parsed * 10 + static_cast<unsigned>(c - '0');
+    }
+    if (parsed < 1 || parsed > MAX_THREADS) return false;
+    threads = parsed;
+    return true;
+}
+
+static void print_usage(const char* program) {
+    std::cerr
+        << "Usage: " << program << " <spec.json> <input.csv|-> [options]\n"
+        << "       " << program << " <spec.json> <input.csv>... --output-dir <dir> [options]\n"
+        << "\n"
+        << "Options:\n"
+        << "  -o, --output <path>    Write output to a file instead of stdout\n"
+        << "  --output-dir <dir>     Run every input, writing each output to <dir>\n"
+        << "                         under the input's file name\n"
+        << "  --compress <codec>     Compress output (none, gzip, zstd); defaults\n"
+        << "                         to the output file extension (.gz, .zst)\n"
+        << "  --snapshot <path>      Also save the parsed input as a columnar snapshot;\n"
+        << "                         snapshots are accepted as input and load without parsing\n"
+        << "  --threads <n>          Parser threads, 1-" << MAX_THREADS << " (default: hardware concurrency)\n"
+        << "  --timing               Print per-node timing to stderr (for each input\n"
+        << "                         with --output-dir)\n"
+        << "  -h, --help             Show this message\n";
+}
+
+// Read-only view of the input: memory-mapped for regular files, buffered
+// for stdin or anything that cannot be mapped
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        if (path == "-") {
+            buffer_.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+            return;
+        }
+
+        fd_ = open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) {
+            throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+        }
+
+        struct stat st;
+        if (fstat(fd_, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            size_ = static_cast<size_t>(st.st_size);
+            void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (addr != MAP_FAILED) {
+                addr_ = addr;
+                madvise(addr_, size_, MADV_SEQUENTIAL);
+                return;
+            }
+            size_ = 0;
+        }
+
+        // Fall back to reading the whole file
+        std::ifstream in(path, std::ios::binary);
+        buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    ~MappedFile() {
+        if (addr_) munmap(addr_, size_);
+        if (fd_ >= 0) close(fd_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return addr_ ? static_cast<const char*>(addr_) : buffer_.data(); }
+    size_t size() const { return addr_ ? size_ : buffer_.size(); }
+
+private:
+    int fd_ = -1;
+    void* addr_ = nullptr;
+    size_t size_ = 0;
+    std::string buffer_;
+};
+
+static std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+static bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+static void print_timing(const char* label, const char* op, double ms, size_t rows) {
+    std::fprintf(stderr, "%-16s %-16s %10.2f ms %12zu rows\n", label, op, ms, rows);
+}
+
+static void print_node_timing(const RunStats& stats) {
+    for (const auto& node : stats.nodes) {
+        print_timing(node.id.c_str(), node.op.c_str(), node.time_ms, node.rows_out);
+    }
+}
+
+static void print_filter_order(const RunStats& stats) {
+    for (const auto& group : stats.filter_order) {
+        std::fprintf(stderr, "filter order:");
+        for (const auto& filter : group) {
+            std::fprintf(stderr, " %s (keeps %.1f%%, %.0f ns/row)",
+                         filter.id.c_str(), filter.selectivity * 100, filter.cost_ns);
+        }
+        std::fprintf(stderr, "\n");
+    }
+}
+
+// Parse an input straight out of its mapping (inflating first if
+// compressed); snapshots are decoded in place without parsing
+static CSVData load_cli_input(const MappedFile& input, unsigned threads, bool& snapshot_input) {
+    snapshot_input = is_snapshot(input.data(), input.size());
+    if (snapshot_input) {
+        return read_snapshot(input.data(), input.size());
+    }
+    Codec input_codec = detect_codec(input.data(), input.size());
+    if (input_codec == Codec::None) {
+        return parse_csv(input.data(), input.size(), ',', threads);
+    }
+    CSVStreamParser parser;
+    decompress_stream(input_codec, input.data(), input.size(), [&](const char* chunk, size_t size) {
+        parser.feed(chunk, size);
+    });
+    return parser.finish();
+}
+
+// Output file for one batch input: the input's file name without its
+// compression suffix, plus the suffix of the output codec
+static std::string batch_output_path(const std::string& dir, const std::string& input, Codec codec) {
+    std::string name = input.substr(input.find_last_of('/') + 1);
+    if (ends_with(name, ".gz")) name.resize(name.size() - 3);
+    else if (ends_with(name, ".zst")) name.resize(name.size() - 4);
+    if (codec == Codec::Gzip) name += ".gz";
+    else if (codec == Codec::Zstd) name += ".zst";
+    return dir + "/" + name;
+}
+
+static void write_file(const std::string& path, const std::string& data, Codec codec) {
+    FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) {
+        throw std::runtime_error("Cannot open " + path + " for writing: " + std::strerror(errno));
+    }
+    bool write_failed = false;
+    {
+        CompressedWriter writer(codec, [&](const char* chunk, size_t size) {
+            if (std::fwrite(chunk, 1, size, out) != size) write_failed = true;
+        });
+        writer.write(data.data(), data.size());
+        writer.finish();
+    }
+    write_failed = std::fclose(out) != 0 || write_failed;
+    if (write_failed) {
+        throw std::runtime_error("Write failed for " + path + ": " + std::strerror(errno));
+    }
+}
+
+// Run the pipeline over every input with one BatchRunner, so the spec is
+// compiled once. Returns the number of inputs that failed; throws before
+// running anything if two outputs collide or an output is an input.
+static int run_batch_inputs(
+    const PipelineSpec& spec,
+    const std::vector<std::string>& inputs,
+    const std::string& output_dir,
+    Codec output_codec,
+    unsigned threads,
+    bool timing
+) {
+    // Refuse to overwrite an input or write two inputs to the same file
+    // before anything runs
+    std::vector<std::string> output_paths;
+    std::vector<std::pair<dev_t, ino_t>> input_ids;
+    for (const auto& input_path : inputs) {
+        output_paths.push_back(batch_output_path(output_dir, input_path, output_codec));
+        struct stat st;
+        if (stat(input_path.c_str(), &st) == 0) {
+            input_ids.emplace_back(st.st_dev, st.st_ino);
+        }
+    }
+    for (size_t i = 0; i < inputs.size(); i++) {
+        for (size_t j = 0; j < i; j++) {
+            if (output_paths[i] == output_paths[j]) {
+                throw std::runtime_error("Inputs " + inputs[j] + " and " + inputs[i] +
+                                         " would both be written to " + output_paths[i]);
+            }
+        }
+        struct stat st;
+        if (stat(output_paths[i].c_str(), &st) == 0 &&
+            std::find(input_ids.begin(), input_ids.end(), std::make_pair(st.st_dev, st.st_ino)) != input_ids.end()) {
+            throw std::runtime_error("Output " + output_paths[i] + " would overwrite an input");
+        }
+    }
+    
+    BatchRunner runner(spec);
+    int failures = 0;
+    
+    for (size_t i = 0; i < inputs.size(); i++) {
+        const std::string& input_path = inputs[i];
+        try {
+            auto parse_start = std::chrono::steady_clock::now();
+            MappedFile input(input_path);
+            bool snapshot_input = false;
+            CSVData csv_data = load_cli_input(input, threads, snapshot_input);
+            double parse_ms = elapsed_ms(parse_start);
+            
+            RunStats stats;
+            const std::string& output = runner.run(csv_data, timing ? &stats : nullptr);
+            
+            auto write_start = std::chrono::steady_clock::now();
+            write_file(output_paths[i], output, output_codec);
+            double write_ms = elapsed_ms(write_start);
+            
+            if (timing) {
+                std::fprintf(stderr, "%s\n", input_path.c_str());
+                print_timing("(input)", snapshot_input ? "load_snapshot" : "parse_csv", parse_ms, csv_data.rows.size());
+                print_node_timing(stats);
+                print_timing("(output)", "write", write_ms, stats.output_rows);
+                print_filter_order(stats);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << input_path << ": Execution error: " << e.what() << "\n";
+            failures++;
+        }
+    }
+    
+    return failures;
+}
+
+int main(int argc, char** argv) {
+    std::string spec_path;
+    std::vector<std::string> inputs;
+    std::string output_path;
+    std::string output_dir;
+    std::string codec_name;
+    std::string snapshot_path;
+    std::string threads_value;
+    bool threads_given = false;
+    bool timing = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next_value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << "\n";
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "-o" || arg == "--output") {
+            output_path = next_value();
+        } else if (arg == "--output-dir") {
+            output_dir = next_value();
+        } else if (arg == "--compress") {
+            codec_name = next_value();
+        } else if (arg == "--snapshot") {
+            snapshot_path = next_value();
+        } else if (arg == "--threads") {
+            threads_value = next_value();
+            threads_given = true;
+        } else if (arg == "--timing") {
+            timing = true;
+        } else if (spec_path.empty()) {
+            spec_path = arg;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+
+    // Several inputs need somewhere to put several outputs
+    if (spec_path.empty() || inputs.empty() ||
+        (inputs.size() > 1 && output_dir.empty()) ||
+        (!output_dir.empty() && (!output_path.empty() || !snapshot_path.empty()))) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    try {
+        // 0 leaves the choice to the parser (hardware concurrency)
+        unsigned threads = 0;
+        if (threads_given && !parse_thread_count(threads_value, threads)) {
+            std::cerr << "Invalid value for --threads: '" << threads_value << "'\n";
+            print_usage(argv[0]);
+            return 2;
+        }
+
+        // Load and validate the spec
+        PipelineSpec spec = PipelineSpec::from_json(json::parse(read_file(spec_path)));
+        ValidationResult validation = validate_pipeline(spec);
+        if (!validation.valid) {
+            for (const auto& error : validation.errors) {
+                std::cerr << "Invalid pipeline: " << error << "\n";
+            }
+            return 1;
+        }
+        for (const auto& warning : validation.warnings) {
+            std::cerr << "Warning: " << warning << "\n";
+        }
+
+        if (codec_name.empty()) {
+            if (ends_with(output_path, ".gz")) codec_name = "gzip";
+            else if (ends_with(output_path, ".zst")) codec_name = "zstd";
+        }
+        Codec output_codec = codec_from_name(codec_name);
+
+        if (!output_dir.empty()) {
+            return run_batch_inputs(spec, inputs, output_dir, output_codec, threads, timing) == 0 ? 0 : 1;
+        }
+        const std::string& input_path = inputs.front();
+
+        auto parse_start = std::chrono::steady_clock::now();
+        MappedFile input(input_path);
+        bool snapshot_input = false;
+        CSVData csv_data = load_cli_input(input, threads, snapshot_input);
+        double parse_ms = elapsed_ms(parse_start);
+        size_t input_rows = csv_data.rows.size();
+
+        if (!snapshot_path.empty()) {
+            write_file(snapshot_path, write_snapshot(csv_data), Codec::None);
+        }
+
+        // Execute
+        RunStats stats;
+        CSVData output = execute_nodes(spec, csv_data, timing ? &stats : nullptr);
+        csv_data = CSVData();
+
+        // Stream the output as it is serialized
+        auto write_start = std::chrono::steady_clock::now();
+        FILE* out = output_path.empty() ? stdout : std::fopen(output_path.c_str(), "wb");
+        if (!out) {
+            throw std::runtime_error("Cannot open " + output_path + " for writing: " + std::strerror(errno));
+        }
+        {
+            CompressedWriter writer(output_codec, [&](const char* chunk, size_t size) {
+                if (std::fwrite(chunk, 1, size, out) != size) {
+                    throw std::runtime_error("Write failed: " + std::string(std::strerror(errno)));
+                }
+            });
+            serialize_csv(output, [&](const char* chunk, size_t size) {
+                writer.write(chunk, size);
+            });
+            writer.finish();
+        }
+        bool write_failed = std::fflush(out) != 0;
+        if (out != stdout) {
+            write_failed = std::fclose(out) != 0 || write_failed;
+        }
+        if (write_failed) {
+            throw std::runtime_error("Write failed: " + std::string(std::strerror(errno)));
+        }
+        double write_ms = elapsed_ms(write_start);
+
+        if (timing) {
+            print_timing("(input)", snapshot_input ? "load_snapshot" : "parse_csv", parse_ms, input_rows);
+            print_node_timing(stats);
+            print_timing("(output)", "serialize", write_ms, output.rows.size());
+            print_filter_order(stats);
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "Execution error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
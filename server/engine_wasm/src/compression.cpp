@@ -0,0 +1,273 @@
+#include "compression.h"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <vector>
+#include <zlib.h>
+#if PIPELINE_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+namespace pipeline {
+
+// Size of the decode/encode staging buffers
+static const size_t STREAM_CHUNK = 64 * 1024;
+
+Codec codec_from_name(const std::string& name) {
+    if (name.empty() || name == "none") {
+        return Codec::None;
+    }
+    if (name == "gzip" || name == "gz") {
+        return Codec::Gzip;
+    }
+    if (name == "zstd" || name == "zst") {
+#if PIPELINE_HAS_ZSTD
+        return Codec::Zstd;
+#else
+        throw std::runtime_error("zstd support not compiled into this engine");
+#endif
+    }
+    throw std::runtime_error("Unknown codec: " + name);
+}
+
+Codec detect_codec(const char* data, size_t size) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    if (size >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b) {
+        return Codec::Gzip;
+    }
+    if (size >= 4 && bytes[0] == 0x28 && bytes[1] == 0xb5 && bytes[2] == 0x2f && bytes[3] == 0xfd) {
+        return Codec::Zstd;
+    }
+    return Codec::None;
+}
+
+// ============================================
+// Decompression
+// ============================================
+
+static void gunzip_stream(const char* data, size_t size, const ByteSink& sink) {
+    z_stream stream = {};
+    // 15 + 32: accept both gzip and zlib headers
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+        throw std::runtime_error("gzip: inflateInit failed");
+    }
+
+    std::vector<char> out(STREAM_CHUNK);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    // avail_in is a uInt: hand zlib the input in slices of at most UINT_MAX
+    size_t remaining = size;
+
+    int ret = Z_OK;
+    while (true) {
+        if (stream.avail_in == 0 && remaining > 0) {
+            stream.avail_in = static_cast<uInt>(std::min<size_t>(remaining, UINT_MAX));
+            remaining -= stream.avail_in;
+        }
+        stream.next_out = reinterpret_cast<Bytef*>(out.data());
+        stream.avail_out = static_cast<uInt>(out.size());
+        ret = inflate(&stream, Z_NO_FLUSH);
+
+        if (ret != Z_OK && ret != Z_STREAM_END) {
+            inflateEnd(&stream);
+            throw std::runtime_error("gzip: corrupt input");
+        }
+
+        size_t produced = out.size() - stream.avail_out;
+        if (produced > 0) {
+            sink(out.data(), produced);
+        }
+
+        if (ret == Z_STREAM_END) {
+            // Concatenated gzip members continue the same stream
+            if (stream.avail_in == 0 && remaining == 0) break;
+            inflateReset(&stream);
+        } else if (stream.avail_in == 0 && remaining == 0 && produced == 0) {
+            inflateEnd(&stream);
+            throw std::runtime_error("gzip: truncated input");
+        }
+    }
+
+    inflateEnd(&stream);
+}
+
+#if PIPELINE_HAS_ZSTD
+static void unzstd_stream(const char* data, size_t size, const ByteSink& sink) {
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+    if (!dctx) {
+        throw std::runtime_error("zstd: out of memory");
+    }
+
+    std::vector<char> out(ZSTD_DStreamOutSize());
+    ZSTD_inBuffer input = { data, size, 0 };
+    size_t last = 0;
+
+    while (input.pos < input.size) {
+        ZSTD_outBuffer output = { out.data(), out.size(), 0 };
+        last = ZSTD_decompressStream(dctx, &output, &input);
+        if (ZSTD_isError(last)) {
+            ZSTD_freeDCtx(dctx);
+            throw std::runtime_error(std::string("zstd: ") + ZSTD_getErrorName(last));
+        }
+        if (output.pos > 0) {
+            sink(out.data(), output.pos);
+        }
+    }
+
+    // Drain anything still buffered in the decoder
+    while (last != 0) {
+        ZSTD_outBuffer output = { out.data(), out.size(), 0 };
+        last = ZSTD_decompressStream(dctx, &output, &input);
+        if (ZSTD_isError(last) || output.pos == 0) {
+            ZSTD_freeDCtx(dctx);
+            throw std::runtime_error("zstd: truncated input");
+        }
+        sink(out.data(), output.pos);
+    }
+
+    ZSTD_freeDCtx(dctx);
+}
+#endif
+
+void decompress_stream(Codec codec, const char* data, size_t size, const ByteSink& sink) {
+    switch (codec) {
+        case Codec::None:
+            if (size > 0) sink(data, size);
+            return;
+        case Codec::Gzip:
+            gunzip_stream(data, size, sink);
+            return;
+        case Codec::Zstd:
+#if PIPELINE_HAS_ZSTD
+            unzstd_stream(data, size, sink);
+            return;
+#else
+            throw std::runtime_error("zstd support not compiled into this engine");
+#endif
+    }
+}
+
+// ============================================
+// Compression
+// ============================================
+
+struct CompressedWriter::Impl {
+    Codec codec;
+    ByteSink sink;
+    std::vector<char> out;
+    z_stream gzip = {};
+#if PIPELINE_HAS_ZSTD
+    ZSTD_CCtx* zstd = nullptr;
+#endif
+    bool finished = false;
+
+    void deflate_chunk(const char* data, size_t size, int flush) {
+        // avail_in is a uInt: only the last slice carries the flush mode
+        while (size > UINT_MAX) {
+            deflate_slice(data, UINT_MAX, Z_NO_FLUSH);
+            data += UINT_MAX;
+            size -= UINT_MAX;
+        }
+        deflate_slice(data, size, flush);
+    }
+
+    void deflate_slice(const char* data, size_t size, int flush) {
+        gzip.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        gzip.avail_in = static_cast<uInt>(size);
+        int ret = Z_OK;
+        do {
+            gzip.next_out = reinterpret_cast<Bytef*>(out.data());
+            gzip.avail_out = static_cast<uInt>(out.size());
+            ret = deflate(&gzip, flush);
+            if (ret == Z_STREAM_ERROR) {
+                throw std::runtime_error("gzip: deflate failed");
+            }
+            size_t produced = out.size() - gzip.avail_out;
+            if (produced > 0) sink(out.data(), produced);
+        } while (gzip.avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+    }
+
+#if PIPELINE_HAS_ZSTD
+    void zstd_chunk(const char* data, size_t size, ZSTD_EndDirective mode) {
+        ZSTD_inBuffer input = { data, size, 0 };
+        size_t remaining = 0;
+        do {
+            ZSTD_outBuffer output = { out.data(), out.size(), 0 };
+            remaining = ZSTD_compressStream2(zstd, &output, &input, mode);
+            if (ZSTD_isError(remaining)) {
+                throw std::runtime_error(std::string("zstd: ") + ZSTD_getErrorName(remaining));
+            }
+            if (output.pos > 0) sink(out.data(), output.pos);
+        } while (mode == ZSTD_e_end ? remaining != 0 : input.pos < input.size);
+    }
+#endif
+};
+
+CompressedWriter::CompressedWriter(Codec codec, ByteSink sink) : impl_(new Impl) {
+    impl_->codec = codec;
+    impl_->sink = std::move(sink);
+
+    if (codec == Codec::Gzip) {
+        impl_->out.resize(STREAM_CHUNK);
+        // 15 + 16: gzip wrapper
+        if (deflateInit2(&impl_->gzip, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw std::runtime_error("gzip: deflateInit failed");
+        }
+    } else if (codec == Codec::Zstd) {
+#if PIPELINE_HAS_ZSTD
+        impl_->out.resize(ZSTD_CStreamOutSize());
+        impl_->zstd = ZSTD_createCCtx();
+        if (!impl_->zstd) {
+            throw std::runtime_error("zstd: out of memory");
+        }
+#else
+        throw std::runtime_error("zstd support not compiled into this engine");
+#endif
+    }
+}
+
+CompressedWriter::~CompressedWriter() {
+    if (impl_->codec == Codec::Gzip) {
+        deflateEnd(&impl_->gzip);
+    }
+#if PIPELINE_HAS_ZSTD
+    if (impl_->zstd) {
+        ZSTD_freeCCtx(impl_->zstd);
+    }
+#endif
+}
+
+void CompressedWriter::write(const char* data, size_t size) {
+    if (size == 0) return;
+    switch (impl_->codec) {
+        case Codec::None:
+            impl_->sink(data, size);
+            break;
+        case Codec::Gzip:
+            impl_->deflate_chunk(data, size, Z_NO_FLUSH);
+            break;
+        case Codec::Zstd:
+#if PIPELINE_HAS_ZSTD
+            impl_->zstd_chunk(data, size, ZSTD_e_continue);
+#endif
+            break;
+    }
+}
+
+void CompressedWriter::finish() {
+    if (impl_->finished) return;
+    impl_->finished = true;
+    switch (impl_->codec) {
+        case Codec::None:
+            break;
+        case Codec::Gzip:
+            impl_->deflate_chunk(nullptr, 0, Z_FINISH);
+            break;
+        case Codec::Zstd:
+#if PIPELINE_HAS_ZSTD
+            impl_->zstd_chunk(nullptr, 0, ZSTD_e_end);
+#endif
+            break;
+    }
+}
+
+} // namespace pipeline
@@ -0,0 +1,49 @@
+#ifndef PIPELINE_COMPRESSION_H
+#define PIPELINE_COMPRESSION_H
+
+#include "types.h"
+#include <memory>
+
+// zstd is optional: Emscripten has no zstd port, so it must be supplied
+#ifndef PIPELINE_HAS_ZSTD
+#define PIPELINE_HAS_ZSTD 0
+#endif
+
+namespace pipeline {
+
+// Supported stream codecs
+enum class Codec {
+    None,
+    Gzip,
+    Zstd
+};
+
+// Parse a codec name ("none", "gzip", "zstd")
+// Throws std::runtime_error for unknown or unavailable codecs
+Codec codec_from_name(const std::string& name);
+
+// Detect the codec from the stream's magic bytes
+Codec detect_codec(const char* data, size_t size);
+
+// Decompress a buffer, handing decoded bytes to sink chunk by chunk
+// Throws std::runtime_error on corrupt input
+void decompress_stream(Codec codec, const char* data, size_t size, const ByteSink& sink);
+
+// Streaming compressor: write() plain bytes, finish() flushes the trailer.
+// Compressed bytes are handed to the sink as they are produced.
+class CompressedWriter {
+public:
+    CompressedWriter(Codec codec, ByteSink sink);
+    ~CompressedWriter();
+
+    void write(const char* data, size_t size);
+    void finish();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace pipeline
+
+#endif // PIPELINE_COMPRESSION_H
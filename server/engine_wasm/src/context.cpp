@@ -0,0 +1,124 @@
+#include "context.h"
+#include "validator.h"
+#include "executor.h"
+#include "compression.h"
+#include "csv_parser.h"
+#include "snapshot.h"
+
+namespace pipeline {
+
+static PipelineSpec parse_spec(const char* spec_json) {
+    return PipelineSpec::from_json(json::parse(spec_json));
+}
+
+const std::string& EngineContext::fail(const std::exception& e) {
+    json error_result = {
+        {"error", true},
+        {"message", std::string("Execution error: ") + e.what()}
+    };
+    result_ = error_result.dump();
+    return result_;
+}
+
+const std::string& EngineContext::validate(const char* spec_json) {
+    try {
+        result_ = validate_pipeline(parse_spec(spec_json)).to_json().dump();
+    } catch (const std::exception& e) {
+        // Report parse failures as a failed validation
+        json error_result = {
+            {"valid", false},
+            {"errors", {std::string("Parse error: ") + e.what()}}
+        };
+        result_ = error_result.dump();
+    }
+    return result_;
+}
+
+const std::string& EngineContext::run(
+    const char* spec_json,
+    const char* input,
+    size_t size,
+    bool collect_stats,
+    bool keep_snapshot
+) {
+    stats_ = "{}";
+    snapshot_.clear();
+    try {
+        PipelineSpec spec = parse_spec(spec_json);
+        RunStats stats;
+        RunStats* run_stats = collect_stats ? &stats : nullptr;
+        
+        if (!keep_snapshot) {
+            result_ = execute_pipeline(spec, input, size, run_stats);
+        } else if (is_snapshot(input, size)) {
+            result_ = execute_pipeline(spec, read_snapshot(input, size), run_stats);
+            snapshot_.assign(input, size);
+        } else {
+            // Parse once: the same rows feed the run and the snapshot
+            CSVData data = parse_csv(input, size);
+            result_ = execute_pipeline(spec, data, run_stats);
+            snapshot_ = write_snapshot(data);
+        }
+        
+        if (collect_stats) {
+            stats_ = stats.to_json().dump();
+        }
+        return result_;
+    } catch (const std::exception& e) {
+        snapshot_.clear();
+        return fail(e);
+    }
+}
+
+const std::string& EngineContext::preview(
+    const char* spec_json,
+    const char* input,
+    size_t size,
+    const char* options_json
+) {
+    try {
+        PipelineSpec spec = parse_spec(spec_json);
+        PreviewOptions options = PreviewOptions::from_json(json::parse(options_json));
+        result_ = execute_pipeline_preview(spec, input, size, options);
+        return result_;
+    } catch (const std::exception& e) {
+        return fail(e);
+    }
+}
+
+const std::string& EngineContext::run_compressed(
+    const char* spec_json,
+    const char* input,
+    size_t size,
+    const char* input_codec,
+    const char* output_codec
+) {
+    try {
+        PipelineSpec spec = parse_spec(spec_json);
+        std::string in_name = input_codec ? input_codec : "auto";
+        Codec in_codec = in_name == "auto" ? detect_codec(input, size) : codec_from_name(in_name);
+        Codec out_codec = codec_from_name(output_codec ? output_codec : "none");
+        result_ = execute_pipeline_compressed(spec, input, size, in_codec, out_codec);
+        return result_;
+    } catch (const std::exception& e) {
+        return fail(e);
+    }
+}
+
+const std::string& EngineContext::snapshot(const char* input, size_t size) {
+    try {
+        result_ = write_snapshot(parse_csv(input, size));
+        return result_;
+    } catch (const std::exception& e) {
+        return fail(e);
+    }
+}
+
+char* EngineContext::input_buffer(size_t size) {
+    if (input_.size() < size + 1) {
+        input_.resize(size + 1);
+    }
+    return &input_[0];
+}
+
+} // namespace pipeline
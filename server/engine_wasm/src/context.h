@@ -0,0 +1,70 @@
+#ifndef PIPELINE_CONTEXT_H
+#define PIPELINE_CONTEXT_H
+
+#include "types.h"
+#include <string>
+
+namespace pipeline {
+
+// Engine context: owns everything a call produces (result, statistics and
+// a reusable input buffer). Contexts share no state, so separate contexts
+// can serve concurrent requests, e.g. one per module instance or thread.
+//
+// Each call returns a reference to the context's result buffer, which stays
+// valid until the next call on the same context. Failures are reported as
+// error JSON {"error": true, "message": "Execution error: ..."}.
+class EngineContext {
+public:
+    // Validation result JSON
+    const std::string& validate(const char* spec_json);
+
+    // Output CSV; with collect_stats, node timings and output column
+    // statistics are available from last_stats() afterwards. With
+    // keep_snapshot, the input parsed for this run is also encoded as a
+    // snapshot, available from last_snapshot()
+    const std::string& run(
+        const char* spec_json,
+        const char* input,
+        size_t size,
+        bool collect_stats = false,
+        bool keep_snapshot = false
+    );
+
+    // At most options.limit output rows as CSV
+    const std::string& preview(const char* spec_json, const char* input, size_t size, const char* options_json);
+
+    // Encoded output bytes; input_codec may be "auto" to sniff the input
+    const std::string& run_compressed(
+        const char* spec_json,
+        const char* input,
+        size_t size,
+        const char* input_codec,
+        const char* output_codec
+    );
+
+    // Snapshot bytes of a CSV input (see snapshot.h); run() and preview()
+    // accept the snapshot in place of CSV text
+    const std::string& snapshot(const char* input, size_t size);
+
+    // RunStats JSON of the last successful run() with statistics, or "{}"
+    const std::string& last_stats() const { return stats_; }
+
+    // Snapshot of the last successful run() with keep_snapshot, or empty
+    const std::string& last_snapshot() const { return snapshot_; }
+
+    // Input staging buffer of at least size bytes, reused across calls so
+    // callers can copy each input in without a separate allocation
+    char* input_buffer(size_t size);
+
+private:
+    const std::string& fail(const std::exception& e);
+
+    std::string result_;
+    std::string stats_ = "{}";
+    std::string snapshot_;
+    std::string input_;
+};
+
+} // namespace pipeline
+
+#endif // PIPELINE_CONTEXT_H
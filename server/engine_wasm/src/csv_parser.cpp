@@ -1,112 +1,293 @@
 #include "csv_parser.h"
-#include <sstream>
+#include "stats.h"
+#include <algorithm>
+#include <iterator>
+#if PIPELINE_HAS_THREADS
+#include <thread>
+#endif
 
 namespace pipeline {
 
-// Parse a single CSV line handling quotes
-static std::vector<std::string> parse_csv_line(const std::string& line, char delimiter) {
-    std::vector<std::string> result;
+// Smallest chunk worth handing to its own parser thread
+static const size_t PARALLEL_PARSE_MIN_CHUNK = 256 * 1024;
+
+static unsigned default_parse_threads() {
+#if PIPELINE_HAS_THREADS
+    unsigned n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+#else
+    return 1;
+#endif
+}
+
+// Run task(i) for i in [0, count), one thread per task when available
+template <typename Task>
+static void run_parallel(size_t count, Task task) {
+#if PIPELINE_HAS_THREADS
+    std::vector<std::thread> workers;
+    workers.reserve(count);
+    for (size_t i = 1; i < count; i++) {
+        workers.emplace_back(task, i);
+    }
+    if (count > 0) task(0);
+    for (auto& worker : workers) worker.join();
+#else
+    for (size_t i = 0; i < count; i++) task(i);
+#endif
+}
+
+// Append a field trimmed of surrounding spaces and tabs
+static void push_trimmed(std::vector<std::string>& row, const std::string& field) {
+    size_t start = field.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        row.emplace_back();
+        return;
+    }
+    size_t end = field.find_last_not_of(" \t");
+    row.emplace_back(field, start, end - start + 1);
+}
+
+// Parse one record starting at p, handling quotes. A newline inside quotes
+// belongs to the field; carriage returns are dropped everywhere.
+// Returns the position after the record's terminating newline (or end), or
+// nullptr if nothing but carriage returns remained. `blank` is set when the
+// record holds only spaces and tabs.
+static const char* parse_record(
+    const char* p,
+    const char* end,
+    char delimiter,
+    std::vector<std::string>& row,
+    bool& blank
+) {
     std::string current;
     bool in_quotes = false;
+    bool has_content = false;
+    bool terminated = false;
+    blank = true;
     
-    for (size_t i = 0; i < line.size(); i++) {
-        char c = line[i];
-        char next = (i + 1 < line.size()) ? line[i + 1] : '\0';
+    while (p < end) {
+        char c = *p++;
+        
+        if (c == '\r') {
+            continue;
+        }
+        if (c == '\n' && !in_quotes) {
+            terminated = true;
+            break;
+        }
+        
+        has_content = true;
+        if (c != ' ' && c != '\t') {
+            blank = false;
+        }
         
         if (in_quotes) {
-            if (c == '"' && next == '"') {
-                // Escaped quote
-                current += '"';
-                i++; // Skip next quote
-            } else if (c == '"') {
-                // End of quoted field
-                in_quotes = false;
-            } else {
-                current += c;
-            }
-        } else {
             if (c == '"') {
-                // Start of quoted field
-                in_quotes = true;
-            } else if (c == delimiter) {
-                // End of field
-                // Trim whitespace
-                size_t start = current.find_first_not_of(" \t");
-                size_t end = current.find_last_not_of(" \t");
-                if (start != std::string::npos) {
-                    result.push_back(current.substr(start, end - start + 1));
+                // Look past carriage returns for an escaped quote
+                const char* next = p;
+                while (next < end && *next == '\r') next++;
+                if (next < end && *next == '"') {
+                    current += '"';
+                    p = next + 1;
                 } else {
-                    result.push_back("");
+                    // End of quoted field
+                    in_quotes = false;
                 }
-                current.clear();
             } else {
                 current += c;
             }
+        } else if (c == '"') {
+            // Start of quoted field
+            in_quotes = true;
+        } else if (c == delimiter) {
+            // End of field
+            push_trimmed(row, current);
+            current.clear();
+        } else {
+            current += c;
         }
     }
     
-    // Don't forget the last field
-    size_t start = current.find_first_not_of(" \t");
-    size_t end = current.find_last_not_of(" \t");
-    if (start != std::string::npos) {
-        result.push_back(current.substr(start, end - start + 1));
-    } else {
-        result.push_back("");
+    if (!has_content && !terminated) {
+        return nullptr;
     }
     
-    return result;
+    // Don't forget the last field
+    push_trimmed(row, current);
+    return p;
 }
 
-// Split string by newlines (handling \r\n and \n)
-static std::vector<std::string> split_lines(const std::string& content) {
-    std::vector<std::string> lines;
-    std::string current;
-    
-    for (size_t i = 0; i < content.size(); i++) {
-        char c = content[i];
-        if (c == '\r') {
-            // Skip \r, next \n will trigger line break
-            continue;
-        } else if (c == '\n') {
-            lines.push_back(current);
-            current.clear();
-        } else {
-            current += c;
+// Parse the records in [p, end) into rows, skipping blank records.
+// The range must start at a record boundary (outside quotes).
+static void parse_records(
+    const char* p,
+    const char* end,
+    char delimiter,
+    std::vector<std::vector<std::string>>& rows
+) {
+    while (p < end) {
+        std::vector<std::string> row;
+        bool blank = false;
+        p = parse_record(p, end, delimiter, row, blank);
+        if (!p) break;
+        if (!blank) {
+            rows.push_back(std::move(row));
         }
     }
+}
+
+// Find the first record boundary at or after p, given whether p lies inside
+// quotes. Quote state is plain quote parity: escaped quotes come in pairs.
+static const char* next_record_boundary(const char* p, const char* end, bool in_quotes) {
+    for (; p < end; p++) {
+        if (*p == '"') {
+            in_quotes = !in_quotes;
+        } else if (*p == '\n' && !in_quotes) {
+            return p + 1;
+        }
+    }
+    return end;
+}
+
+// Split the body into chunks at record boundaries and parse them in parallel.
+// A pre-scan counts quotes per nominal chunk so each boundary's quote state
+// is known exactly; the stitched result matches the sequential parse.
+static void parse_records_parallel(
+    const char* begin,
+    const char* end,
+    char delimiter,
+    size_t chunk_count,
+    std::vector<std::vector<std::string>>& rows
+) {
+    size_t size = static_cast<size_t>(end - begin);
+    std::vector<const char*> nominal(chunk_count + 1);
+    for (size_t i = 0; i <= chunk_count; i++) {
+        nominal[i] = begin + size * i / chunk_count;
+    }
+    
+    // Pre-scan: quote parity of each nominal chunk
+    std::vector<char> odd_quotes(chunk_count, 0);
+    run_parallel(chunk_count, [&](size_t i) {
+        size_t quotes = std::count(nominal[i], nominal[i + 1], '"');
+        odd_quotes[i] = static_cast<char>(quotes & 1);
+    });
     
-    // Add last line if not empty
-    if (!current.empty()) {
-        lines.push_back(current);
+    // Resolve each nominal cut to the next newline outside quotes
+    std::vector<const char*> cuts(chunk_count + 1);
+    cuts[0] = begin;
+    cuts[chunk_count] = end;
+    bool in_quotes = false;
+    for (size_t i = 1; i < chunk_count; i++) {
+        in_quotes = in_quotes != (odd_quotes[i - 1] != 0);
+        cuts[i] = std::max(next_record_boundary(nominal[i], end, in_quotes), cuts[i - 1]);
     }
     
-    return lines;
+    std::vector<std::vector<std::vector<std::string>>> chunk_rows(chunk_count);
+    run_parallel(chunk_count, [&](size_t i) {
+        parse_records(cuts[i], cuts[i + 1], delimiter, chunk_rows[i]);
+    });
+    
+    size_t total = rows.size();
+    for (const auto& chunk : chunk_rows) total += chunk.size();
+    rows.reserve(total);
+    for (auto& chunk : chunk_rows) {
+        std::move(chunk.begin(), chunk.end(), std::back_inserter(rows));
+    }
 }
 
-CSVData parse_csv(const std::string& csv_content, char delimiter) {
+CSVData parse_csv(const char* csv_content, size_t size, char delimiter, unsigned threads) {
     CSVData data;
+    const char* end = csv_content + size;
     
-    auto lines = split_lines(csv_content);
-    if (lines.empty()) {
+    // First record is headers
+    bool blank = false;
+    const char* body = parse_record(csv_content, end, delimiter, data.headers, blank);
+    if (!body) {
         return data;
     }
     
-    // First line is headers
-    data.headers = parse_csv_line(lines[0], delimiter);
+    // Remaining records are data rows
+    size_t body_size = static_cast<size_t>(end - body);
+    size_t chunk_count = std::min<size_t>(
+        threads ? threads : default_parse_threads(),
+        body_size / PARALLEL_PARSE_MIN_CHUNK
+    );
+#ifdef PIPELINE_THREAD_POOL_SIZE
+    chunk_count = std::min<size_t>(chunk_count, PIPELINE_THREAD_POOL_SIZE);
+#endif
+    if (chunk_count > 1) {
+        parse_records_parallel(body, end, delimiter, chunk_count, data.rows);
+    } else {
+        parse_records(body, end, delimiter, data.rows);
+    }
     
-    // Remaining lines are data rows
-    for (size_t i = 1; i < lines.size(); i++) {
-        const auto& line = lines[i];
-        // Skip empty lines
-        if (line.find_first_not_of(" \t\r\n") == std::string::npos) {
-            continue;
+    return data;
+}
+
+CSVData parse_csv(const std::string& csv_content, char delimiter) {
+    return parse_csv(csv_content.data(), csv_content.size(), delimiter);
+}
+
+// ============================================
+// Streaming Parser
+// ============================================
+
+CSVStreamParser::CSVStreamParser(char delimiter) : delimiter_(delimiter) {}
+
+void CSVStreamParser::feed(const char* data, size_t size) {
+    pending_.append(data, size);
+    
+    // Track quote state over the new bytes to find the last record boundary
+    size_t boundary = 0;
+    for (size_t i = scanned_; i < pending_.size(); i++) {
+        char c = pending_[i];
+        if (c == '"') {
+            in_quotes_ = !in_quotes_;
+        } else if (c == '\n' && !in_quotes_) {
+            boundary = i + 1;
         }
-        data.rows.push_back(parse_csv_line(line, delimiter));
     }
+    scanned_ = pending_.size();
     
-    return data;
+    if (boundary > 0) {
+        consume(pending_.data(), pending_.data() + boundary);
+        pending_.erase(0, boundary);
+        scanned_ -= boundary;
+    }
+}
+
+std::vector<std::vector<std::string>> CSVStreamParser::take_rows() {
+    std::vector<std::vector<std::string>> rows;
+    rows.swap(data_.rows);
+    return rows;
+}
+
+CSVData CSVStreamParser::finish() {
+    consume(pending_.data(), pending_.data() + pending_.size());
+    pending_.clear();
+    scanned_ = 0;
+    return std::move(data_);
+}
+
+void CSVStreamParser::consume(const char* begin, const char* end) {
+    if (!has_headers_) {
+        // First record is headers
+        bool blank = false;
+        const char* body = parse_record(begin, end, delimiter_, data_.headers, blank);
+        if (!body) return;
+        has_headers_ = true;
+        begin = body;
+    }
+    parse_records(begin, end, delimiter_, data_.rows);
 }
 
+// ============================================
+// Serialization
+// ============================================
+
+// Flush serialized output to the sink once this much is buffered
+static const size_t SERIALIZE_FLUSH_BYTES = 64 * 1024;
+
 // Check if a field needs quoting
 static bool needs_quoting(const std::string& field, char delimiter) {
     return field.find(delimiter) != std::string::npos ||
@@ -115,43 +296,67 @@ static bool needs_quoting(const std::string& field, char delimiter) {
            field.find('\r') != std::string::npos;
 }
 
-// Escape a field for CSV output
-static std::string escape_field(const std::string& field, char delimiter) {
-    if (needs_quoting(field, delimiter)) {
-        std::string escaped = "\"";
-        for (char c : field) {
-            if (c == '"') {
-                escaped += "\"\""; // Escape quotes by doubling
-            } else {
-                escaped += c;
-            }
+// Append a field to out, escaping it for CSV output
+static void append_field(std::string& out, const std::string& field, char delimiter) {
+    if (!needs_quoting(field, delimiter)) {
+        out += field;
+        return;
+    }
+    out += '"';
+    for (char c : field) {
+        if (c == '"') {
+            out += "\"\""; // Escape quotes by doubling
+        } else {
+            out += c;
         }
-        escaped += "\"";
-        return escaped;
     }
-    return field;
+    out += '"';
 }
 
-std::string serialize_csv(const CSVData& data, char delimiter) {
-    std::ostringstream oss;
+// Append one CSV line
+static void append_line(std::string& out, const std::vector<std::string>& fields, char delimiter) {
+    for (size_t i = 0; i < fields.size(); i++) {
+        if (i > 0) out += delimiter;
+        append_field(out, fields[i], delimiter);
+    }
+    out += '\n';
+}
+
+void serialize_csv(const CSVData& data, const ByteSink& sink, char delimiter, ColumnStatsCollector* stats) {
+    std::string buffer;
+    buffer.reserve(SERIALIZE_FLUSH_BYTES * 2);
     
     // Write headers
-    for (size_t i = 0; i < data.headers.size(); i++) {
-        if (i > 0) oss << delimiter;
-        oss << escape_field(data.headers[i], delimiter);
-    }
-    oss << "\n";
+    append_line(buffer, data.headers, delimiter);
     
     // Write rows
     for (const auto& row : data.rows) {
-        for (size_t i = 0; i < row.size(); i++) {
-            if (i > 0) oss << delimiter;
-            oss << escape_field(row[i], delimiter);
+        append_line(buffer, row, delimiter);
+        if (stats) stats->add_row(row);
+        if (buffer.size() >= SERIALIZE_FLUSH_BYTES) {
+            sink(buffer.data(), buffer.size());
+            buffer.clear();
         }
-        oss << "\n";
     }
     
-    return oss.str();
+    if (!buffer.empty()) {
+        sink(buffer.data(), buffer.size());
+    }
+}
+
+std::string serialize_csv(const CSVData& data, char delimiter, ColumnStatsCollector* stats) {
+    std::string output;
+    
+    // Write headers
+    append_line(output, data.headers, delimiter);
+    
+    // Write rows
+    for (const auto& row : data.rows) {
+        append_line(output, row, delimiter);
+        if (stats) stats->add_row(row);
+    }
+    
+    return output;
 }
 
 } // namespace pipeline
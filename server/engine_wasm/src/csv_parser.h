@@ -3,13 +3,76 @@
 
 #include "types.h"
 
+// Threads are available natively and in pthread-enabled WASM builds
+#ifndef PIPELINE_HAS_THREADS
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define PIPELINE_HAS_THREADS 0
+#else
+#define PIPELINE_HAS_THREADS 1
+#endif
+#endif
+
+// Emscripten can only start a thread synchronously from its pre-spawned
+// worker pool, and the parser blocks in join() on the calling thread, so a
+// WASM build never asks for more threads than the pool holds. The Makefile
+// passes the same value as PTHREAD_POOL_SIZE.
+#if defined(__EMSCRIPTEN__) && !defined(PIPELINE_THREAD_POOL_SIZE)
+#define PIPELINE_THREAD_POOL_SIZE 4
+#endif
+
 namespace pipeline {
 
 // Parse CSV string into CSVData structure
 CSVData parse_csv(const std::string& csv_content, char delimiter = ',');
 
+// Parse a CSV buffer, splitting large inputs into chunks parsed on separate
+// threads (threads = 0 uses the hardware concurrency). Output is identical
+// to the sequential parse.
+CSVData parse_csv(const char* csv_content, size_t size, char delimiter = ',', unsigned threads = 0);
+
+// Incremental parser for input that arrives in chunks (e.g. while it is
+// being decompressed). Complete records are parsed as soon as they arrive;
+// only the trailing partial record is buffered.
+class CSVStreamParser {
+public:
+    explicit CSVStreamParser(char delimiter = ',');
+
+    // Feed the next chunk of input
+    void feed(const char* data, size_t size);
+
+    // Headers, once the first record has been parsed
+    const std::vector<std::string>& headers() const { return data_.headers; }
+
+    // Move out the rows parsed so far
+    std::vector<std::vector<std::string>> take_rows();
+
+    // Parse whatever remains and return the dataset
+    CSVData finish();
+
+private:
+    void consume(const char* begin, const char* end);
+
+    char delimiter_;
+    CSVData data_;
+    bool has_headers_ = false;
+    std::string pending_;
+    size_t scanned_ = 0;
+    bool in_quotes_ = false;
+};
+
+class ColumnStatsCollector;
+
 // Serialize CSVData back to CSV string
-std::string serialize_csv(const CSVData& data, char delimiter = ',');
+// Column statistics are gathered in the same pass when stats is non-null
+std::string serialize_csv(const CSVData& data, char delimiter = ',', ColumnStatsCollector* stats = nullptr);
+
+// Serialize CSVData, handing the output to sink in chunks
+void serialize_csv(
+    const CSVData& data,
+    const ByteSink& sink,
+    char delimiter = ',',
+    ColumnStatsCollector* stats = nullptr
+);
 
 } // namespace pipeline
 
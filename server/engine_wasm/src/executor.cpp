@@ -1,11 +1,19 @@
 #include "executor.h"
 #include "csv_parser.h"
+#include "expression.h"
+#include "stats.h"
+#include "snapshot.h"
 #include <algorithm>
 #include <cctype>
+#include <random>
 #include <regex>
+#include <stdexcept>
 #include <sstream>
 #include <iomanip>
+#include <optional>
 #include <ctime>
+#include <chrono>
+#include <limits>
 
 namespace pipeline {
 
@@ -19,19 +27,6 @@ static std::string to_lower(const std::string& s) {
     return result;
 }
 
-static std::string to_upper(const std::string& s) {
-    std::string result = s;
-    std::transform(result.begin(), result.end(), result.begin(), ::toupper);
-    return result;
-}
-
-static std::string trim(const std::string& s) {
-    size_t start = s.find_first_not_of(" \t\r\n");
-    if (start == std::string::npos) return "";
-    size_t end = s.find_last_not_of(" \t\r\n");
-    return s.substr(start, end - start + 1);
-}
-
 static bool is_number(const std::string& s) {
     if (s.empty()) return false;
     try {
@@ -42,27 +37,58 @@ static bool is_number(const std::string& s) {
     }
 }
 
+// Parse CSV text, or load a columnar snapshot without parsing
+static CSVData load_input(const char* input, size_t size) {
+    return is_snapshot(input, size) ? read_snapshot(input, size) : parse_csv(input, size);
+}
+
+// Narrow a selection in place, keeping the rows for which keep(record) is true
+template <typename Predicate>
+static void narrow_selection(
+    const std::vector<Record>& data,
+    SelectionVector& selection,
+    Predicate keep
+) {
+    size_t out = 0;
+    for (size_t idx : selection) {
+        if (keep(data[idx])) {
+            selection[out++] = idx;
+        }
+    }
+    selection.resize(out);
+}
+
 // ============================================
 // Operation Implementations
 // ============================================
 
-// Filter operation
-static void execute_filter(
-    std::vector<Record>& data,
-    const json& config
-) {
+// Filter condition parsed once per run (or batch of runs)
+struct CompiledFilter {
+    enum class Op { Equal, NotEqual, Greater, Less, GreaterEqual, LessEqual, Contains };
+    
+    bool active = false;        // false when the condition is empty or unparseable
+    std::string column;
+    Op op = Op::Equal;
+    std::string value;
+    std::string value_lower;    // for contains
+    bool value_is_number = false;
+    double number = 0;
+};
+
+static CompiledFilter compile_filter(const json& config) {
+    CompiledFilter filter;
     std::string condition = config.value("condition", "");
-    if (condition.empty()) return;
+    if (condition.empty()) return filter;
     
     // Parse simple conditions: column == 'value', column > 100, column contains 'text'
-    std::regex pattern(R"((\w+)\s*(==|!=|>|<|>=|<=|contains)\s*(.+))");
+    static const std::regex pattern(R"((\w+)\s*(==|!=|>|<|>=|<=|contains)\s*(.+))");
     std::smatch match;
     
     if (!std::regex_match(condition, match, pattern)) {
-        return; // Can't parse, skip filter
+        return filter; // Can't parse, skip filter
     }
     
-    std::string column = match[1].str();
+    filter.column = match[1].str();
     std::string op = match[2].str();
     std::string raw_value = match[3].str();
     
@@ -73,47 +99,208 @@ static void execute_filter(
         raw_value = raw_value.substr(1, raw_value.size() - 2);
     }
     
-    data.erase(std::remove_if(data.begin(), data.end(), [&](const Record& record) {
-        auto it = record.find(column);
-        if (it == record.end()) return true; // Remove if column doesn't exist
+    if (op == "==") filter.op = CompiledFilter::Op::Equal;
+    else if (op == "!=") filter.op = CompiledFilter::Op::NotEqual;
+    else if (op == ">") filter.op = CompiledFilter::Op::Greater;
+    else if (op == "<") filter.op = CompiledFilter::Op::Less;
+    else if (op == ">=") filter.op = CompiledFilter::Op::GreaterEqual;
+    else if (op == "<=") filter.op = CompiledFilter::Op::LessEqual;
+    else filter.op = CompiledFilter::Op::Contains;
+    
+    filter.value = raw_value;
+    filter.value_lower = to_lower(raw_value);
+    filter.value_is_number = is_number(raw_value);
+    if (filter.value_is_number) {
+        filter.number = std::stod(raw_value);
+    }
+    filter.active = true;
+    return filter;
+}
+
+// Whether a row passes a filter
+static bool filter_matches(const CompiledFilter& filter, const Record& record) {
+    auto it = record.find(filter.column);
+    if (it == record.end()) return false; // Remove if column doesn't exist
+    
+    const std::string& cell_value = it->second;
+    
+    switch (filter.op) {
+        case CompiledFilter::Op::Equal:
+            return cell_value == filter.value;
+        case CompiledFilter::Op::NotEqual:
+            return cell_value != filter.value;
+        case CompiledFilter::Op::Contains:
+            return to_lower(cell_value).find(filter.value_lower) != std::string::npos;
+        default:
+            break;
+    }
+    
+    // Numeric comparisons
+    if (!filter.value_is_number || !is_number(cell_value)) {
+        return false;
+    }
+    double number = std::stod(cell_value);
+    switch (filter.op) {
+        case CompiledFilter::Op::Greater:      return number > filter.number;
+        case CompiledFilter::Op::Less:         return number < filter.number;
+        case CompiledFilter::Op::GreaterEqual: return number >= filter.number;
+        case CompiledFilter::Op::LessEqual:    return number <= filter.number;
+        default:                               return true;
+    }
+}
+
+// Rows measured against every filter of a group before it is reordered.
+// Groups that see fewer rows than this keep the spec order.
+static const size_t FILTER_SAMPLE_ROWS = 1024;
+
+// Consecutive filters commute (each decides on a row's own cells), so they
+// run as one short-circuited conjunction. The evaluation order is chosen
+// once the group has sampled enough rows, possibly over several batches:
+// cheapest cost per discarded row first.
+struct FilterGroup {
+    std::vector<size_t> order;          // node indices of active filters, in evaluation order
+    std::vector<double> selectivity;    // fraction of sampled rows kept, per order entry
+    std::vector<double> cost_ns;        // time per sampled row, per order entry
+    bool calibrated = false;
+    
+    // Sample so far, per entry of the spec order (until calibrated)
+    size_t sampled = 0;
+    std::vector<size_t> sample_kept;
+    std::vector<double> sample_ns;
+};
+
+// Return a group to the spec order, to be calibrated again on new rows
+static void reset_filter_group(FilterGroup& group) {
+    std::sort(group.order.begin(), group.order.end());
+    group.selectivity.clear();
+    group.cost_ns.clear();
+    group.calibrated = group.order.size() < 2; // A single filter has nothing to reorder
+    group.sampled = 0;
+    group.sample_kept.clear();
+    group.sample_ns.clear();
+}
+
+// Measure each filter on the rows of the selection the sample still needs,
+// and sort the group once the sample is full.
+// Returns, per measured row, the position of the first filter (in the
+// group's order after this call) that rejects it, or the group size when
+// every filter keeps it
+static std::vector<size_t> sample_filters(
+    const std::vector<Record>& data,
+    const SelectionVector& selection,
+    const std::map<size_t, CompiledFilter>& filters,
+    FilterGroup& group
+) {
+    size_t count = group.order.size();
+    size_t sample = std::min(selection.size(), FILTER_SAMPLE_ROWS - group.sampled);
+    std::vector<std::vector<char>> passed(count, std::vector<char>(sample));
+    group.sample_kept.resize(count);
+    group.sample_ns.resize(count);
+    
+    // Evaluate every filter on every sampled row, one filter at a time
+    for (size_t k = 0; k < count; k++) {
+        const CompiledFilter& filter = filters.at(group.order[k]);
+        size_t kept = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < sample; r++) {
+            passed[k][r] = filter_matches(filter, data[selection[r]]);
+            kept += passed[k][r];
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        group.sample_kept[k] += kept;
+        group.sample_ns[k] += elapsed.count();
+    }
+    group.sampled += sample;
+    
+    std::vector<size_t> ranked(count);
+    for (size_t k = 0; k < count; k++) ranked[k] = k;
+    
+    if (group.sampled >= FILTER_SAMPLE_ROWS) {
+        std::vector<double> selectivity(count), cost_ns(count);
+        for (size_t k = 0; k < count; k++) {
+            selectivity[k] = static_cast<double>(group.sample_kept[k]) / group.sampled;
+            cost_ns[k] = group.sample_ns[k] / group.sampled;
+        }
         
-        const std::string& cell_value = it->second;
+        // Rank by cost / (1 - selectivity); filters that keep everything go last
+        auto rank = [&](size_t k) {
+            double dropped = 1.0 - selectivity[k];
+            return dropped > 0 ? cost_ns[k] / dropped : std::numeric_limits<double>::infinity();
+        };
+        std::stable_sort(ranked.begin(), ranked.end(), [&](size_t a, size_t b) {
+            return rank(a) < rank(b);
+        });
         
-        if (op == "==") {
-            return cell_value != raw_value;
-        } else if (op == "!=") {
-            return cell_value == raw_value;
-        } else if (op == ">") {
-            if (is_number(cell_value) && is_number(raw_value)) {
-                return std::stod(cell_value) <= std::stod(raw_value);
-            }
-            return true;
-        } else if (op == "<") {
-            if (is_number(cell_value) && is_number(raw_value)) {
-                return std::stod(cell_value) >= std::stod(raw_value);
-            }
-            return true;
-        } else if (op == ">=") {
-            if (is_number(cell_value) && is_number(raw_value)) {
-                return std::stod(cell_value) < std::stod(raw_value);
-            }
-            return true;
-        } else if (op == "<=") {
-            if (is_number(cell_value) && is_number(raw_value)) {
-                return std::stod(cell_value) > std::stod(raw_value);
+        std::vector<size_t> order(count);
+        for (size_t p = 0; p < count; p++) {
+            order[p] = group.order[ranked[p]];
+            group.selectivity.push_back(selectivity[ranked[p]]);
+            group.cost_ns.push_back(cost_ns[ranked[p]]);
+        }
+        group.order = std::move(order);
+        group.calibrated = true;
+        group.sample_kept.clear();
+        group.sample_ns.clear();
+    }
+    
+    std::vector<size_t> first_rejection(sample);
+    for (size_t r = 0; r < sample; r++) {
+        size_t p = 0;
+        while (p < count && passed[ranked[p]][r]) p++;
+        first_rejection[r] = p;
+    }
+    return first_rejection;
+}
+
+// Filter operation over a group of consecutive filters
+// rejected receives, per order entry, the number of rows it removed
+static void execute_filters(
+    const std::vector<Record>& data,
+    SelectionVector& selection,
+    const std::map<size_t, CompiledFilter>& filters,
+    FilterGroup& group,
+    std::vector<size_t>& rejected
+) {
+    rejected.assign(group.order.size(), 0);
+    if (group.order.empty() || selection.empty()) return;
+    
+    // Rows sampled for calibration were already evaluated against every filter
+    size_t out = 0;
+    size_t next = 0;
+    if (!group.calibrated) {
+        std::vector<size_t> first_rejection = sample_filters(data, selection, filters, group);
+        for (size_t r = 0; r < first_rejection.size(); r++) {
+            if (first_rejection[r] == group.order.size()) {
+                selection[out++] = selection[r];
+            } else {
+                rejected[first_rejection[r]]++;
             }
-            return true;
-        } else if (op == "contains") {
-            return to_lower(cell_value).find(to_lower(raw_value)) == std::string::npos;
         }
-        
-        return false;
-    }), data.end());
+        next = first_rejection.size();
+    }
+    
+    std::vector<const CompiledFilter*> compiled;
+    for (size_t index : group.order) {
+        compiled.push_back(&filters.at(index));
+    }
+    
+    for (; next < selection.size(); next++) {
+        size_t idx = selection[next];
+        size_t p = 0;
+        while (p < compiled.size() && filter_matches(*compiled[p], data[idx])) p++;
+        if (p == compiled.size()) {
+            selection[out++] = idx;
+        } else {
+            rejected[p]++;
+        }
+    }
+    selection.resize(out);
 }
 
 // Select columns operation
 static void execute_select_columns(
     std::vector<Record>& data,
+    const SelectionVector& selection,
     std::vector<std::string>& headers,
     const json& config
 ) {
@@ -124,8 +311,9 @@ static void execute_select_columns(
     // Update headers
     headers = columns;
     
-    // Update records to only keep selected columns
-    for (auto& record : data) {
+    // Update selected records to only keep selected columns
+    for (size_t idx : selection) {
+        Record& record = data[idx];
         Record new_record;
         for (const auto& col : columns) {
             auto it = record.find(col);
@@ -135,34 +323,33 @@ static void execute_select_columns(
     }
 }
 
-// Dedupe operation
+// Dedupe operation (seen keys persist across batches of the same run)
 static void execute_dedupe(
-    std::vector<Record>& data,
-    const json& config
+    const std::vector<Record>& data,
+    SelectionVector& selection,
+    const json& config,
+    std::set<std::string>& seen
 ) {
     if (!config.contains("key_columns") || !config["key_columns"].is_array()) return;
     
     std::vector<std::string> key_columns = config["key_columns"].get<std::vector<std::string>>();
-    std::set<std::string> seen;
     
-    data.erase(std::remove_if(data.begin(), data.end(), [&](const Record& record) {
+    narrow_selection(data, selection, [&](const Record& record) {
         std::string key;
         for (const auto& col : key_columns) {
             auto it = record.find(col);
             key += (it != record.end() ? it->second : "") + "|";
         }
         
-        if (seen.count(key)) {
-            return true; // Duplicate, remove
-        }
-        seen.insert(key);
-        return false;
-    }), data.end());
+        // Keep only the first occurrence of each key
+        return seen.insert(key).second;
+    });
 }
 
 // Rename columns operation
 static void execute_rename_columns(
     std::vector<Record>& data,
+    const SelectionVector& selection,
     std::vector<std::string>& headers,
     const json& config
 ) {
@@ -179,7 +366,8 @@ static void execute_rename_columns(
     }
     
     // Update records
-    for (auto& record : data) {
+    for (size_t idx : selection) {
+        Record& record = data[idx];
         Record new_record;
         for (const auto& [key, value] : record) {
             auto it = mapping.find(key);
@@ -190,43 +378,45 @@ static void execute_rename_columns(
     }
 }
 
-// Transform operation
-static void execute_transform(
-    std::vector<Record>& data,
-    const json& config
-) {
-    std::string column = config.value("column", "");
+// Transform node compiled once per run
+struct CompiledTransform {
+    std::string column;
+    std::optional<Expression> program; // empty when the expression is invalid
+};
+
+static CompiledTransform compile_transform(const json& config) {
+    CompiledTransform transform;
+    transform.column = config.value("column", "");
     std::string expression = config.value("expression", "");
     
-    if (column.empty() || expression.empty()) return;
+    if (transform.column.empty() || expression.empty()) return transform;
     
-    for (auto& record : data) {
-        auto it = record.find(column);
-        if (it == record.end()) continue;
-        
-        std::string value = it->second;
-        
-        if (expression == "lower(value)") {
-            record[column] = to_lower(value);
-        } else if (expression == "upper(value)") {
-            record[column] = to_upper(value);
-        } else if (expression == "trim(value)") {
-            record[column] = trim(value);
-        } else if (expression.find("replace(") == 0) {
-            // Parse replace(value, 'old', 'new')
-            std::regex replace_pattern(R"(replace\(value,\s*'([^']*)',\s*'([^']*)'\))");
-            std::smatch match;
-            if (std::regex_match(expression, match, replace_pattern)) {
-                std::string old_str = match[1].str();
-                std::string new_str = match[2].str();
-                size_t pos = 0;
-                std::string result = value;
-                while ((pos = result.find(old_str, pos)) != std::string::npos) {
-                    result.replace(pos, old_str.length(), new_str);
-                    pos += new_str.length();
-                }
-                record[column] = result;
-            }
+    try {
+        transform.program = Expression::compile(expression);
+    } catch (const std::exception&) {
+        // Can't parse, skip transform
+    }
+    return transform;
+}
+
+// Transform operation: a run of consecutive transform nodes is applied in
+// one pass, each row flowing through every compiled program in order
+static void execute_transforms(
+    std::vector<Record>& data,
+    const SelectionVector& selection,
+    const std::vector<CompiledTransform*>& transforms
+) {
+    std::string result;
+    for (size_t idx : selection) {
+        Record& record = data[idx];
+        for (CompiledTransform* transform : transforms) {
+            if (!transform->program) continue;
+            
+            auto it = record.find(transform->column);
+            if (it == record.end()) continue;
+            
+            transform->program->evaluate(it->second, result);
+            it->second.swap(result);
         }
     }
 }
@@ -234,6 +424,7 @@ static void execute_transform(
 // Validate email operation
 static void execute_validate_email(
     std::vector<Record>& data,
+    const SelectionVector& selection,
     std::vector<std::string>& headers,
     const json& config
 ) {
@@ -253,7 +444,8 @@ static void execute_validate_email(
     
     const std::regex& pattern = strict ? strict_pattern : loose_pattern;
     
-    for (auto& record : data) {
+    for (size_t idx : selection) {
+        Record& record = data[idx];
         auto it = record.find(column);
         std::string email = (it != record.end()) ? it->second : "";
         bool is_valid = std::regex_match(email, pattern);
@@ -264,6 +456,7 @@ static void execute_validate_email(
 // Fix dates operation
 static void execute_fix_dates(
     std::vector<Record>& data,
+    const SelectionVector& selection,
     const json& config
 ) {
     std::string column = config.value("column", "");
@@ -271,7 +464,8 @@ static void execute_fix_dates(
     
     if (column.empty()) return;
     
-    for (auto& record : data) {
+    for (size_t idx : selection) {
+        Record& record = data[idx];
         auto it = record.find(column);
         if (it == record.end()) continue;
         
@@ -323,51 +517,409 @@ static void execute_fix_dates(
 // Main Executor
 // ============================================
 
-std::string execute_pipeline(const PipelineSpec& spec, const std::string& input_csv) {
-    // Parse input CSV
-    CSVData csv_data = parse_csv(input_csv);
-    
-    // Convert to records for easier manipulation
-    std::vector<Record> data = csv_to_records(csv_data);
-    std::vector<std::string> headers = csv_data.headers;
+// Operator state that must persist across batches of one run.
+// Compiled filters and transforms depend only on the spec, so a batch
+// runner keeps them across inputs and only resets the dedupe keys.
+struct ExecutionState {
+    std::map<size_t, std::set<std::string>> dedupe_seen;    // keyed by node index
+    std::map<size_t, CompiledFilter> filters;               // compiled on first use
+    std::map<size_t, FilterGroup> filter_groups;            // keyed by first node index
+    std::map<size_t, CompiledTransform> transforms;         // compiled on first use
+};
+
+// Run every node over one batch of records
+// Timings accumulate into stats across batches when it is non-null
+static void run_nodes(
+    const PipelineSpec& spec,
+    std::vector<Record>& data,
+    SelectionVector& selection,
+    std::vector<std::string>& headers,
+    ExecutionState& state,
+    RunStats* stats
+) {
+    if (stats && stats->nodes.size() != spec.nodes.size()) {
+        stats->nodes.assign(spec.nodes.size(), NodeStats{});
+        for (size_t i = 0; i < spec.nodes.size(); i++) {
+            stats->nodes[i].id = spec.nodes[i].id;
+            stats->nodes[i].op = spec.nodes[i].op;
+        }
+    }
     
-    // Execute each node
-    for (const auto& node : spec.nodes) {
+    for (size_t i = 0; i < spec.nodes.size(); i++) {
+        const auto& node = spec.nodes[i];
+        size_t last = i; // last node handled by this step
+        std::vector<size_t> filter_rows_out; // per node of a filter group
+        auto start = std::chrono::steady_clock::now();
+        
         if (node.op == "parse_csv") {
             // Already parsed, nothing to do
-            continue;
         }
         else if (node.op == "output_csv") {
             // Will be handled at the end
-            continue;
         }
         else if (node.op == "filter") {
-            execute_filter(data, node.config);
+            // Run consecutive filters as one reordered conjunction
+            while (last + 1 < spec.nodes.size() && spec.nodes[last + 1].op == "filter") {
+                last++;
+            }
+            auto group = state.filter_groups.find(i);
+            if (group == state.filter_groups.end()) {
+                FilterGroup created;
+                for (size_t k = i; k <= last; k++) {
+                    auto it = state.filters.emplace(k, compile_filter(spec.nodes[k].config)).first;
+                    if (it->second.active) {
+                        created.order.push_back(k);
+                    }
+                }
+                reset_filter_group(created);
+                group = state.filter_groups.emplace(i, std::move(created)).first;
+            }
+            
+            size_t rows_in = selection.size();
+            std::vector<size_t> rejected;
+            execute_filters(data, selection, state.filters, group->second, rejected);
+            
+            // Rows left after each node; inactive filters keep everything
+            filter_rows_out.assign(last - i + 1, rows_in);
+            size_t remaining = rows_in;
+            for (size_t p = 0; p < rejected.size(); p++) {
+                remaining -= rejected[p];
+                filter_rows_out[group->second.order[p] - i] = remaining;
+            }
         }
         else if (node.op == "select_columns") {
-            execute_select_columns(data, headers, node.config);
+            execute_select_columns(data, selection, headers, node.config);
         }
         else if (node.op == "dedupe") {
-            execute_dedupe(data, node.config);
+            execute_dedupe(data, selection, node.config, state.dedupe_seen[i]);
         }
         else if (node.op == "rename_columns") {
-            execute_rename_columns(data, headers, node.config);
+            execute_rename_columns(data, selection, headers, node.config);
         }
         else if (node.op == "transform") {
-            execute_transform(data, node.config);
+            // Fuse consecutive transforms into a single pass
+            while (last + 1 < spec.nodes.size() && spec.nodes[last + 1].op == "transform") {
+                last++;
+            }
+            std::vector<CompiledTransform*> group;
+            for (size_t k = i; k <= last; k++) {
+                auto it = state.transforms.find(k);
+                if (it == state.transforms.end()) {
+                    it = state.transforms.emplace(k, compile_transform(spec.nodes[k].config)).first;
+                }
+                group.push_back(&it->second);
+            }
+            execute_transforms(data, selection, group);
         }
         else if (node.op == "validate_email") {
-            execute_validate_email(data, headers, node.config);
+            execute_validate_email(data, selection, headers, node.config);
         }
         else if (node.op == "fix_dates") {
-            execute_fix_dates(data, node.config);
+            execute_fix_dates(data, selection, node.config);
         }
         // Unknown operations are skipped
+        
+        if (stats) {
+            // Fused nodes share one pass; split its time evenly
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            for (size_t k = i; k <= last; k++) {
+                stats->nodes[k].time_ms += elapsed.count() / (last - i + 1);
+                stats->nodes[k].rows_out += filter_rows_out.empty() ? selection.size() : filter_rows_out[k - i];
+            }
+        }
+        i = last;
+    }
+    
+    if (stats) {
+        // Report the order each reordered filter group settled on
+        stats->filter_order.clear();
+        for (const auto& entry : state.filter_groups) {
+            const FilterGroup& group = entry.second;
+            if (group.selectivity.empty()) continue;
+            std::vector<FilterStats> filters;
+            for (size_t p = 0; p < group.order.size(); p++) {
+                filters.push_back(FilterStats{
+                    spec.nodes[group.order[p]].id, group.selectivity[p], group.cost_ns[p]
+                });
+            }
+            stats->filter_order.push_back(std::move(filters));
+        }
+    }
+}
+
+// Run every node over a batch of parsed rows and return the surviving rows
+static CSVData run_batch(
+    const PipelineSpec& spec,
+    const CSVData& batch,
+    ExecutionState& state,
+    RunStats* stats = nullptr
+) {
+    // Convert to records for easier manipulation
+    std::vector<Record> data = csv_to_records(batch);
+    std::vector<std::string> headers = batch.headers;
+    
+    // Filter and dedupe narrow the selection; other ops only touch live rows
+    SelectionVector selection = select_all(data.size());
+    
+    run_nodes(spec, data, selection, headers, state, stats);
+    
+    // Materialize the surviving rows
+    return records_to_csv(data, selection, headers);
+}
+
+CSVData execute_nodes(const PipelineSpec& spec, const CSVData& csv_data, RunStats* stats) {
+    ExecutionState state;
+    return run_batch(spec, csv_data, state, stats);
+}
+
+std::string execute_pipeline(const PipelineSpec& spec, const std::string& input_csv, RunStats* stats) {
+    return execute_pipeline(spec, input_csv.data(), input_csv.size(), stats);
+}
+
+std::string execute_pipeline(const PipelineSpec& spec, const char* input, size_t input_size, RunStats* stats) {
+    // Parse input CSV (or load a snapshot)
+    return execute_pipeline(spec, load_input(input, input_size), stats);
+}
+
+std::string execute_pipeline(const PipelineSpec& spec, const CSVData& csv_data, RunStats* stats) {
+    // Run the nodes and convert back to CSV
+    CSVData output = execute_nodes(spec, csv_data, stats);
+    if (!stats) {
+        return serialize_csv(output);
+    }
+    
+    // Column statistics are gathered while serializing
+    ColumnStatsCollector collector(output.headers);
+    std::string output_csv = serialize_csv(output, ',', &collector);
+    stats->input_rows = csv_data.rows.size();
+    stats->output_rows = output.rows.size();
+    stats->columns = collector.finish();
+    return output_csv;
+}
+
+// ============================================
+// Batch Execution
+// ============================================
+
+struct BatchRunner::Impl {
+    PipelineSpec spec;
+    ExecutionState state;
+    std::string output;
+};
+
+BatchRunner::BatchRunner(const PipelineSpec& spec) : impl_(new Impl) {
+    impl_->spec = spec;
+}
+
+BatchRunner::~BatchRunner() = default;
+
+const std::string& BatchRunner::run(const char* input, size_t size, RunStats* stats) {
+    return run(load_input(input, size), stats);
+}
+
+const std::string& BatchRunner::run(const CSVData& csv_data, RunStats* stats) {
+    // Inputs are independent; only the compiled operators carry over.
+    // Filter groups are reordered on each input's own rows.
+    impl_->state.dedupe_seen.clear();
+    for (auto& entry : impl_->state.filter_groups) {
+        reset_filter_group(entry.second);
+    }
+    impl_->output.clear();
+    
+    CSVData result = run_batch(impl_->spec, csv_data, impl_->state, stats);
+    
+    auto append = [this](const char* chunk, size_t chunk_size) {
+        impl_->output.append(chunk, chunk_size);
+    };
+    if (!stats) {
+        serialize_csv(result, append);
+        return impl_->output;
+    }
+    
+    ColumnStatsCollector collector(result.headers);
+    serialize_csv(result, append, ',', &collector);
+    stats->input_rows = csv_data.rows.size();
+    stats->output_rows = result.rows.size();
+    stats->columns = collector.finish();
+    return impl_->output;
+}
+
+// ============================================
+// Preview Execution
+// ============================================
+
+// Input slice fed to the streaming parser per preview batch
+static const size_t PREVIEW_BATCH_BYTES = 64 * 1024;
+
+// Snapshot rows decoded per preview batch
+static const uint64_t PREVIEW_BATCH_ROWS = 4096;
+
+// Seeded reservoir sample of output rows, kept in input order
+class RowReservoir {
+public:
+    RowReservoir(size_t capacity, uint64_t seed) : capacity_(capacity), rng_(seed) {}
+    
+    void offer(std::vector<std::string>&& row) {
+        size_t position = seen_++;
+        if (rows_.size() < capacity_) {
+            rows_.emplace_back(position, std::move(row));
+            return;
+        }
+        // Explicit modulo keeps samples identical across standard libraries
+        size_t slot = static_cast<size_t>(rng_() % seen_);
+        if (slot < capacity_) {
+            rows_[slot] = { position, std::move(row) };
+        }
+    }
+    
+    std::vector<std::vector<std::string>> take_rows() {
+        std::sort(rows_.begin(), rows_.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+        std::vector<std::vector<std::string>> rows;
+        rows.reserve(rows_.size());
+        for (auto& entry : rows_) {
+            rows.push_back(std::move(entry.second));
+        }
+        return rows;
+    }
+    
+private:
+    size_t capacity_;
+    size_t seen_ = 0;
+    std::mt19937_64 rng_;
+    std::vector<std::pair<size_t, std::vector<std::string>>> rows_;
+};
+
+static bool has_blocking_op(const PipelineSpec& spec) {
+    for (const auto& node : spec.nodes) {
+        if (BLOCKING_OPS.count(node.op)) return true;
+    }
+    return false;
+}
+
+std::string execute_pipeline_preview(
+    const PipelineSpec& spec,
+    const std::string& input_csv,
+    const PreviewOptions& options
+) {
+    return execute_pipeline_preview(spec, input_csv.data(), input_csv.size(), options);
+}
+
+std::string execute_pipeline_preview(
+    const PipelineSpec& spec,
+    const char* input,
+    size_t input_size,
+    const PreviewOptions& options
+) {
+    if (options.limit == 0) {
+        throw std::runtime_error("Preview limit must be positive");
     }
     
-    // Convert back to CSV
-    CSVData output = records_to_csv(data, headers);
+    RowReservoir reservoir(options.limit, options.seed);
+    CSVData output;
+    
+    // Snapshots: decode and run batch by batch, stopping once the head is full
+    bool snapshot = is_snapshot(input, input_size);
+    if (snapshot && !options.sample && !has_blocking_op(spec)) {
+        ExecutionState state;
+        uint64_t rows = snapshot_row_count(input, input_size);
+        uint64_t first = 0;
+        do {
+            CSVData result = run_batch(spec, read_snapshot(input, input_size, first, PREVIEW_BATCH_ROWS), state);
+            output.headers = std::move(result.headers);
+            for (auto& row : result.rows) {
+                if (output.rows.size() == options.limit) break;
+                output.rows.push_back(std::move(row));
+            }
+            first += PREVIEW_BATCH_ROWS;
+        } while (first < rows && output.rows.size() < options.limit);
+        return serialize_csv(output);
+    }
+    
+    // Blocking operators need the whole input: run fully, then sample
+    if (has_blocking_op(spec) || snapshot) {
+        output = execute_nodes(spec, load_input(input, input_size));
+        for (auto& row : output.rows) {
+            reservoir.offer(std::move(row));
+        }
+        output.rows = reservoir.take_rows();
+        return serialize_csv(output);
+    }
+    
+    // Streaming: parse and run batch by batch, stopping once the head is full
+    CSVStreamParser parser;
+    ExecutionState state;
+    bool done = false;
+    
+    auto process = [&](const CSVData& batch) {
+        CSVData result = run_batch(spec, batch, state);
+        output.headers = std::move(result.headers);
+        for (auto& row : result.rows) {
+            if (options.sample) {
+                reservoir.offer(std::move(row));
+            } else if (output.rows.size() < options.limit) {
+                output.rows.push_back(std::move(row));
+            }
+        }
+        done = !options.sample && output.rows.size() >= options.limit;
+    };
+    
+    size_t offset = 0;
+    while (offset < input_size && !done) {
+        size_t size = std::min(PREVIEW_BATCH_BYTES, input_size - offset);
+        parser.feed(input + offset, size);
+        offset += size;
+        
+        CSVData batch;
+        batch.rows = parser.take_rows();
+        if (!batch.rows.empty()) {
+            batch.headers = parser.headers();
+            process(batch);
+        }
+    }
+    if (!done) {
+        process(parser.finish());
+    }
+    
+    if (options.sample) {
+        output.rows = reservoir.take_rows();
+    }
     return serialize_csv(output);
 }
 
+std::string execute_pipeline_compressed(
+    const PipelineSpec& spec,
+    const char* input,
+    size_t input_size,
+    Codec input_codec,
+    Codec output_codec
+) {
+    // Parse while decompressing; the inflated text is never held in full
+    CSVData csv_data;
+    if (input_codec == Codec::None) {
+        csv_data = load_input(input, input_size);
+    } else {
+        CSVStreamParser parser;
+        decompress_stream(input_codec, input, input_size, [&](const char* chunk, size_t size) {
+            parser.feed(chunk, size);
+        });
+        csv_data = parser.finish();
+    }
+    
+    CSVData output = execute_nodes(spec, csv_data);
+    
+    // Compress while serializing
+    std::string encoded;
+    CompressedWriter writer(output_codec, [&](const char* chunk, size_t size) {
+        encoded.append(chunk, size);
+    });
+    serialize_csv(output, [&](const char* chunk, size_t size) {
+        writer.write(chunk, size);
+    });
+    writer.finish();
+    
+    return encoded;
+}
+
 } // namespace pipeline
@@ -2,13 +2,75 @@
 #define PIPELINE_EXECUTOR_H
 
 #include "types.h"
+#include "compression.h"
+#include <memory>
 #include <string>
 
 namespace pipeline {
 
 // Execute a pipeline on input CSV data
-// Returns output CSV string on success, or error JSON on failure
-std::string execute_pipeline(const PipelineSpec& spec, const std::string& input_csv);
+// Returns output CSV string on success, or error JSON on failure.
+// When stats is non-null it receives per-node timings, row counts and
+// output column statistics (collected in the serialization pass).
+std::string execute_pipeline(const PipelineSpec& spec, const std::string& input_csv, RunStats* stats = nullptr);
+std::string execute_pipeline(const PipelineSpec& spec, const char* input, size_t input_size, RunStats* stats = nullptr);
+
+// Execute a pipeline on an already parsed dataset and serialize the output
+std::string execute_pipeline(const PipelineSpec& spec, const CSVData& input, RunStats* stats = nullptr);
+
+// Execute a pipeline on an already parsed dataset
+// Per-node timings are recorded into stats when it is non-null
+CSVData execute_nodes(const PipelineSpec& spec, const CSVData& input, RunStats* stats = nullptr);
+
+// Runs one pipeline over many independent inputs. The spec's filters and
+// transforms are compiled once and the output buffer is reused; per-input
+// operator state (dedupe keys, filter order) starts fresh for every input.
+class BatchRunner {
+public:
+    explicit BatchRunner(const PipelineSpec& spec);
+    ~BatchRunner();
+
+    BatchRunner(const BatchRunner&) = delete;
+    BatchRunner& operator=(const BatchRunner&) = delete;
+
+    // Run one CSV input. The returned output stays valid until the next
+    // call. Throws std::runtime_error on failure; the runner stays usable.
+    const std::string& run(const char* input, size_t size, RunStats* stats = nullptr);
+
+    // Run one already parsed input (e.g. from a streaming decompress)
+    const std::string& run(const CSVData& input, RunStats* stats = nullptr);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// Execute a pipeline for preview, returning at most options.limit output
+// rows as CSV. Pipelines without blocking operators are run batch by batch
+// and parsing stops once enough rows are produced; otherwise, and in sample
+// mode, the result is a seeded reservoir sample of the output rows.
+std::string execute_pipeline_preview(
+    const PipelineSpec& spec,
+    const std::string& input_csv,
+    const PreviewOptions& options
+);
+std::string execute_pipeline_preview(
+    const PipelineSpec& spec,
+    const char* input,
+    size_t input_size,
+    const PreviewOptions& options
+);
+
+// Execute a pipeline on (possibly compressed) input bytes. The input is
+// decompressed as it is parsed and the output is compressed as it is
+// serialized. Returns the encoded output bytes.
+std::string execute_pipeline_compressed(
+    const PipelineSpec& spec,
+    const char* input,
+    size_t input_size,
+    Codec input_codec,
+    Codec output_codec
+);
 
 } // namespace pipeline
 
@@ -0,0 +1,371 @@
+#include "expression.h"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <stdexcept>
+
+namespace pipeline {
+
+// ============================================
+// Parsing
+// ============================================
+
+// Parsed expression tree (only lives until code generation)
+struct Expression::Node {
+    enum class Kind { Value, String, Number, Call };
+    
+    Kind kind = Kind::Value;
+    std::string text;   // literal text or function name
+    long number = 0;
+    std::vector<Node> args;
+};
+
+// Recursive-descent parser over the expression source
+struct Expression::Parser {
+    const std::string& src;
+    size_t pos = 0;
+    
+    explicit Parser(const std::string& source) : src(source) {}
+    
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::runtime_error(message + " at position " + std::to_string(pos) + " in '" + src + "'");
+    }
+    
+    void skip_space() {
+        while (pos < src.size() && std::isspace(static_cast<unsigned char>(src[pos]))) pos++;
+    }
+    
+    bool accept(char c) {
+        skip_space();
+        if (pos < src.size() && src[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+    
+    void expect(char c) {
+        if (!accept(c)) fail(std::string("expected '") + c + "'");
+    }
+    
+    Node parse() {
+        Node node = parse_expr();
+        skip_space();
+        if (pos != src.size()) fail("unexpected trailing input");
+        return node;
+    }
+    
+    Node parse_expr() {
+        skip_space();
+        if (pos >= src.size()) fail("unexpected end of expression");
+        
+        Node node;
+        char c = src[pos];
+        
+        if (c == '\'' || c == '"') {
+            // String literal
+            size_t close = src.find(c, pos + 1);
+            if (close == std::string::npos) fail("unterminated string");
+            node.kind = Node::Kind::String;
+            node.text = src.substr(pos + 1, close - pos - 1);
+            pos = close + 1;
+            return node;
+        }
+        
+        if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) {
+            // Integer literal
+            size_t start = pos++;
+            while (pos < src.size() && std::isdigit(static_cast<unsigned char>(src[pos]))) pos++;
+            if (pos == start + 1 && c == '-') fail("expected digits");
+            node.kind = Node::Kind::Number;
+            node.number = std::stol(src.substr(start, pos - start));
+            return node;
+        }
+        
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            size_t start = pos;
+            while (pos < src.size() && (std::isalnum(static_cast<unsigned char>(src[pos])) || src[pos] == '_')) pos++;
+            std::string name = src.substr(start, pos - start);
+            
+            if (name == "value") {
+                node.kind = Node::Kind::Value;
+                return node;
+            }
+            
+            // Function call
+            node.kind = Node::Kind::Call;
+            node.text = name;
+            expect('(');
+            if (!accept(')')) {
+                do {
+                    node.args.push_back(parse_expr());
+                } while (accept(','));
+                expect(')');
+            }
+            return node;
+        }
+        
+        fail(std::string("unexpected character '") + c + "'");
+    }
+};
+
+// ============================================
+// Code Generation
+// ============================================
+
+static void check_arity(const std::string& name, size_t count, size_t min_args, size_t max_args) {
+    if (count < min_args || count > max_args) {
+        throw std::runtime_error("Wrong number of arguments to " + name + "()");
+    }
+}
+
+Expression Expression::compile(const std::string& source) {
+    Expression expression;
+    Parser parser(source);
+    expression.emit(parser.parse(), 0);
+    return expression;
+}
+
+void Expression::emit(const Node& node, size_t depth) {
+    if (stack_.size() < depth + 1) {
+        stack_.resize(depth + 1);
+    }
+    
+    auto literal_string = [&](const Node& arg) -> int32_t {
+        if (arg.kind != Node::Kind::String) {
+            throw std::runtime_error(node.text + "() expects a string literal argument");
+        }
+        constants_.push_back(arg.text);
+        return static_cast<int32_t>(constants_.size() - 1);
+    };
+    auto literal_number = [&](const Node& arg) -> int32_t {
+        if (arg.kind != Node::Kind::Number) {
+            throw std::runtime_error(node.text + "() expects an integer literal argument");
+        }
+        // Instruction operands are 32-bit
+        if (arg.number < std::numeric_limits<int32_t>::min() ||
+            arg.number > std::numeric_limits<int32_t>::max()) {
+            throw std::runtime_error(node.text + "() argument out of range: " + std::to_string(arg.number));
+        }
+        return static_cast<int32_t>(arg.number);
+    };
+    
+    switch (node.kind) {
+        case Node::Kind::Value:
+            code_.push_back({ OpCode::PushValue, 0, 0 });
+            return;
+        case Node::Kind::String:
+            constants_.push_back(node.text);
+            code_.push_back({ OpCode::PushConst, static_cast<int32_t>(constants_.size() - 1), 0 });
+            return;
+        case Node::Kind::Number:
+            // Numbers used as values behave like their text
+            constants_.push_back(std::to_string(node.number));
+            code_.push_back({ OpCode::PushConst, static_cast<int32_t>(constants_.size() - 1), 0 });
+            return;
+        case Node::Kind::Call:
+            break;
+    }
+    
+    const std::string& name = node.text;
+    const auto& args = node.args;
+    
+    // Variadic functions: every argument is an expression
+    if (name == "concat" || name == "coalesce") {
+        check_arity(name, args.size(), 1, 64);
+        for (size_t i = 0; i < args.size(); i++) {
+            emit(args[i], depth + i);
+        }
+        OpCode op = name == "concat" ? OpCode::Concat : OpCode::Coalesce;
+        code_.push_back({ op, static_cast<int32_t>(args.size()), 0 });
+        return;
+    }
+    
+    // Unary string functions
+    static const std::pair<const char*, OpCode> unary[] = {
+        { "lower", OpCode::Lower },
+        { "upper", OpCode::Upper },
+        { "trim", OpCode::Trim },
+        { "ltrim", OpCode::LTrim },
+        { "rtrim", OpCode::RTrim },
+        { "title", OpCode::Title },
+        { "digits", OpCode::Digits },
+    };
+    for (const auto& [fn, op] : unary) {
+        if (name == fn) {
+            check_arity(name, args.size(), 1, 1);
+            emit(args[0], depth);
+            code_.push_back({ op, 0, 0 });
+            return;
+        }
+    }
+    
+    // Functions whose extra arguments are literals baked into the instruction
+    if (name == "replace") {
+        check_arity(name, args.size(), 3, 3);
+        emit(args[0], depth);
+        int32_t from = literal_string(args[1]);
+        int32_t to = literal_string(args[2]);
+        code_.push_back({ OpCode::Replace, from, to });
+        return;
+    }
+    if (name == "substr") {
+        check_arity(name, args.size(), 2, 3);
+        emit(args[0], depth);
+        int32_t start = literal_number(args[1]);
+        int32_t length = args.size() == 3 ? literal_number(args[2]) : -1;
+        if (start < 0 || (args.size() == 3 && length < 0)) {
+            throw std::runtime_error("substr() expects non-negative positions");
+        }
+        code_.push_back({ OpCode::Substr, start, length });
+        return;
+    }
+    if (name == "left" || name == "right") {
+        check_arity(name, args.size(), 2, 2);
+        emit(args[0], depth);
+        int32_t count = literal_number(args[1]);
+        if (count < 0) {
+            throw std::runtime_error(name + "() expects a non-negative count");
+        }
+        code_.push_back({ name == "left" ? OpCode::Left : OpCode::Right, count, 0 });
+        return;
+    }
+    
+    throw std::runtime_error("Unknown function: " + name + "()");
+}
+
+// ============================================
+// Evaluation
+// ============================================
+
+static bool is_trim_char(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+void Expression::evaluate(const std::string& value, std::string& out) {
+    size_t sp = 0;
+    
+    for (const Instruction& ins : code_) {
+        switch (ins.op) {
+            case OpCode::PushValue:
+                stack_[sp++].assign(value);
+                break;
+                
+            case OpCode::PushConst:
+                stack_[sp++].assign(constants_[ins.a]);
+                break;
+                
+            case OpCode::Lower: {
+                std::string& s = stack_[sp - 1];
+                for (char& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                break;
+            }
+                
+            case OpCode::Upper: {
+                std::string& s = stack_[sp - 1];
+                for (char& c : s) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                break;
+            }
+                
+            case OpCode::Trim:
+            case OpCode::LTrim:
+            case OpCode::RTrim: {
+                std::string& s = stack_[sp - 1];
+                if (ins.op != OpCode::LTrim) {
+                    size_t end = s.size();
+                    while (end > 0 && is_trim_char(s[end - 1])) end--;
+                    s.resize(end);
+                }
+                if (ins.op != OpCode::RTrim) {
+                    size_t start = 0;
+                    while (start < s.size() && is_trim_char(s[start])) start++;
+                    s.erase(0, start);
+                }
+                break;
+            }
+                
+            case OpCode::Title: {
+                std::string& s = stack_[sp - 1];
+                bool word_start = true;
+                for (char& c : s) {
+                    unsigned char u = static_cast<unsigned char>(c);
+                    c = static_cast<char>(word_start ? std::toupper(u) : std::tolower(u));
+                    word_start = !std::isalnum(u);
+                }
+                break;
+            }
+                
+            case OpCode::Digits: {
+                std::string& s = stack_[sp - 1];
+                s.erase(std::remove_if(s.begin(), s.end(), [](char c) {
+                    return !std::isdigit(static_cast<unsigned char>(c));
+                }), s.end());
+                break;
+            }
+                
+            case OpCode::Replace: {
+                std::string& s = stack_[sp - 1];
+                const std::string& from = constants_[ins.a];
+                const std::string& to = constants_[ins.b];
+                if (from.empty() || s.find(from) == std::string::npos) break;
+                
+                scratch_.clear();
+                size_t pos = 0;
+                size_t hit;
+                while ((hit = s.find(from, pos)) != std::string::npos) {
+                    scratch_.append(s, pos, hit - pos);
+                    scratch_ += to;
+                    pos = hit + from.size();
+                }
+                scratch_.append(s, pos, std::string::npos);
+                s.swap(scratch_);
+                break;
+            }
+                
+            case OpCode::Substr: {
+                std::string& s = stack_[sp - 1];
+                size_t start = std::min(static_cast<size_t>(ins.a), s.size());
+                size_t length = ins.b < 0 ? std::string::npos : static_cast<size_t>(ins.b);
+                s = s.substr(start, length);
+                break;
+            }
+                
+            case OpCode::Left: {
+                std::string& s = stack_[sp - 1];
+                if (s.size() > static_cast<size_t>(ins.a)) s.resize(ins.a);
+                break;
+            }
+                
+            case OpCode::Right: {
+                std::string& s = stack_[sp - 1];
+                if (s.size() > static_cast<size_t>(ins.a)) s.erase(0, s.size() - ins.a);
+                break;
+            }
+                
+            case OpCode::Concat: {
+                size_t base = sp - ins.a;
+                for (size_t i = base + 1; i < sp; i++) {
+                    stack_[base] += stack_[i];
+                }
+                sp = base + 1;
+                break;
+            }
+                
+            case OpCode::Coalesce: {
+                size_t base = sp - ins.a;
+                for (size_t i = base; i < sp; i++) {
+                    if (!stack_[i].empty()) {
+                        if (i != base) stack_[base].swap(stack_[i]);
+                        break;
+                    }
+                }
+                sp = base + 1;
+                break;
+            }
+        }
+    }
+    
+    out.swap(stack_[0]);
+}
+
+} // namespace pipeline
@@ -0,0 +1,64 @@
+#ifndef PIPELINE_EXPRESSION_H
+#define PIPELINE_EXPRESSION_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pipeline {
+
+// Transform expression compiled once into a small stack program.
+//
+// Grammar:  expr := value | 'text' | "text" | name(expr, ...)
+// Functions (all string -> string, composable):
+//   lower(x), upper(x), trim(x), ltrim(x), rtrim(x), title(x), digits(x),
+//   replace(x, 'old', 'new'), substr(x, start[, length]), left(x, n),
+//   right(x, n), concat(x, y, ...), coalesce(x, y, ...)
+// e.g. "lower(trim(value))", "concat(left(value, 3), '-', right(value, 4))"
+class Expression {
+public:
+    // Parse and compile; throws std::runtime_error on invalid expressions
+    static Expression compile(const std::string& source);
+
+    // Evaluate for one cell value, writing the result to out.
+    // Reuses internal scratch buffers, so an instance is not thread-safe.
+    void evaluate(const std::string& value, std::string& out);
+
+private:
+    enum class OpCode : uint8_t {
+        PushValue,
+        PushConst,
+        Lower,
+        Upper,
+        Trim,
+        LTrim,
+        RTrim,
+        Title,
+        Digits,
+        Replace,   // a = old constant, b = new constant
+        Substr,    // a = start, b = length (-1 = to end)
+        Left,      // a = count
+        Right,     // a = count
+        Concat,    // a = argument count
+        Coalesce   // a = argument count
+    };
+
+    struct Instruction {
+        OpCode op;
+        int32_t a;
+        int32_t b;
+    };
+
+    struct Node;
+    struct Parser;
+    void emit(const Node& node, size_t depth);
+
+    std::vector<Instruction> code_;
+    std::vector<std::string> constants_;
+    std::vector<std::string> stack_;
+    std::string scratch_;
+};
+
+} // namespace pipeline
+
+#endif // PIPELINE_EXPRESSION_H
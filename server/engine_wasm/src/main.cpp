@@ -1,9 +1,10 @@
 #include <emscripten.h>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include "types.h"
-#include "validator.h"
 #include "executor.h"
+#include "context.h"
 
 using namespace pipeline;
 
@@ -16,61 +17,255 @@ static char* copy_to_heap(const std::string& str) {
     return result;
 }
 
+// Helper to allocate and copy a binary result (may contain NUL bytes)
+static char* copy_bytes_to_heap(const std::string& bytes, int* size_out) {
+    char* result = (char*)malloc(bytes.size() + 1);
+    if (result) {
+        memcpy(result, bytes.data(), bytes.size());
+        result[bytes.size()] = '\0';
+    }
+    if (size_out) {
+        *size_out = result ? static_cast<int>(bytes.size()) : 0;
+    }
+    return result;
+}
+
+// State behind a batch handle: the runner, or the error that prevented
+// creating it, plus the buffer holding the latest result
+struct PipelineBatch {
+    std::unique_ptr<BatchRunner> runner;
+    std::string error;
+    std::string result;
+};
+
+static json error_json(const std::string& message) {
+    return json{
+        {"error", true},
+        {"message", std::string("Execution error: ") + message}
+    };
+}
+
 extern "C" {
 
+// ============================================
+// Engine Contexts
+// ============================================
+// Results returned by engine_* calls are owned by the context and stay
+// valid until the next call on that context; they must not be passed to
+// free_result. Contexts share no state.
+
+// Create an engine context
+EMSCRIPTEN_KEEPALIVE
+void* engine_create() {
+    return new EngineContext();
+}
+
+// Destroy an engine context and everything it owns
+EMSCRIPTEN_KEEPALIVE
+void engine_destroy(void* ctx) {
+    delete static_cast<EngineContext*>(ctx);
+}
+
+// Input staging buffer of at least size bytes, reused across calls
+EMSCRIPTEN_KEEPALIVE
+char* engine_input_buffer(void* ctx, int size) {
+    return static_cast<EngineContext*>(ctx)->input_buffer(static_cast<size_t>(size));
+}
+
+// Validate a pipeline specification
+// Output: JSON string of ValidationResult {"valid": bool, "errors": string[]}
+EMSCRIPTEN_KEEPALIVE
+const char* engine_validate(void* ctx, const char* spec_json) {
+    return static_cast<EngineContext*>(ctx)->validate(spec_json).c_str();
+}
+
+// Execute a pipeline on input_size bytes of CSV or snapshot (engine_snapshot)
+// Output: CSV string (on success) or JSON error (on failure). With
+//         collect_stats != 0 the run's statistics are then available from
+//         engine_last_stats
+EMSCRIPTEN_KEEPALIVE
+const char* engine_run(void* ctx, const char* spec_json, const char* input, int input_size, int collect_stats) {
+    return static_cast<EngineContext*>(ctx)
+        ->run(spec_json, input, static_cast<size_t>(input_size), collect_stats != 0).c_str();
+}
+
+// Execute a pipeline like engine_run and also keep its input as a columnar
+// snapshot, so a caller can cache it without a second parse
+// Output: as engine_run; the snapshot is then available from
+//         engine_last_snapshot
+EMSCRIPTEN_KEEPALIVE
+const char* engine_run_snapshotting(void* ctx, const char* spec_json, const char* input, int input_size, int collect_stats) {
+    return static_cast<EngineContext*>(ctx)
+        ->run(spec_json, input, static_cast<size_t>(input_size), collect_stats != 0, true).c_str();
+}
+
+// Snapshot kept by the context's last engine_run_snapshotting
+// Output: snapshot bytes (empty if that run failed); *output_size receives
+//         the length
+EMSCRIPTEN_KEEPALIVE
+const char* engine_last_snapshot(void* ctx, int* output_size) {
+    const std::string& snapshot = static_cast<EngineContext*>(ctx)->last_snapshot();
+    if (output_size) {
+        *output_size = static_cast<int>(snapshot.size());
+    }
+    return snapshot.data();
+}
+
+// Statistics of the context's last engine_run with collect_stats
+// Output: JSON string of RunStats
+//         {"nodes": [...], "input_rows", "output_rows", "columns": [...],
+//          "filter_order": [[{"id", "selectivity", "cost_ns"}, ...], ...]}
+EMSCRIPTEN_KEEPALIVE
+const char* engine_last_stats(void* ctx) {
+    return static_cast<EngineContext*>(ctx)->last_stats().c_str();
+}
+
+// Execute a pipeline for an interactive preview
+// Output: CSV string with at most `limit` rows (on success) or JSON error
+EMSCRIPTEN_KEEPALIVE
+const char* engine_preview(void* ctx, const char* spec_json, const char* input, int input_size, const char* options_json) {
+    return static_cast<EngineContext*>(ctx)
+        ->preview(spec_json, input, static_cast<size_t>(input_size), options_json).c_str();
+}
+
+// Execute a pipeline on (possibly compressed) input bytes
+// Output: encoded CSV bytes (on success) or JSON error; *output_size
+//         receives the length
+EMSCRIPTEN_KEEPALIVE
+const char* engine_run_compressed(
+    void* ctx,
+    const char* spec_json,
+    const char* input,
+    int input_size,
+    const char* input_codec,
+    const char* output_codec,
+    int* output_size
+) {
+    const std::string& result = static_cast<EngineContext*>(ctx)
+        ->run_compressed(spec_json, input, static_cast<size_t>(input_size), input_codec, output_codec);
+    if (output_size) {
+        *output_size = static_cast<int>(result.size());
+    }
+    return result.data();
+}
+
+// Encode input_size bytes of CSV as a columnar snapshot, which engine_run
+// and engine_preview accept in place of the CSV without parsing it again
+// Output: snapshot bytes (on success) or JSON error; *output_size receives
+//         the length
+EMSCRIPTEN_KEEPALIVE
+const char* engine_snapshot(void* ctx, const char* input, int input_size, int* output_size) {
+    const std::string& result = static_cast<EngineContext*>(ctx)->snapshot(input, static_cast<size_t>(input_size));
+    if (output_size) {
+        *output_size = static_cast<int>(result.size());
+    }
+    return result.data();
+}
+
+// ============================================
+// One-shot Calls
+// ============================================
+// Each call runs in a temporary context and returns a malloc'd copy of the
+// result, to be released with free_result.
+
 // Validate a pipeline specification
 // Input: JSON string of PipelineSpec
 // Output: JSON string of ValidationResult {"valid": bool, "errors": string[]}
 EMSCRIPTEN_KEEPALIVE
 const char* validate_pipeline(const char* spec_json) {
+    EngineContext ctx;
+    return copy_to_heap(ctx.validate(spec_json));
+}
+
+// Execute a pipeline on input CSV data
+// Input: JSON string of PipelineSpec, input_size bytes of CSV or snapshot
+//        (engine_snapshot; binary, so the length is always explicit)
+// Output: CSV string (on success) or JSON error (on failure)
+EMSCRIPTEN_KEEPALIVE
+const char* run_pipeline(const char* spec_json, const char* input, int input_size) {
+    EngineContext ctx;
+    return copy_to_heap(ctx.run(spec_json, input, static_cast<size_t>(input_size)));
+}
+
+// Execute a pipeline for an interactive preview
+// Input: JSON string of PipelineSpec, input_size bytes of CSV or snapshot,
+//        JSON preview options
+//        {"limit": number, "mode": "head" | "sample", "seed": number}
+// Output: CSV string with at most `limit` rows (on success) or JSON error
+EMSCRIPTEN_KEEPALIVE
+const char* preview_pipeline(const char* spec_json, const char* input, int input_size, const char* options_json) {
+    EngineContext ctx;
+    return copy_to_heap(ctx.preview(spec_json, input, static_cast<size_t>(input_size), options_json));
+}
+
+// Execute a pipeline on compressed input bytes
+// Input: JSON string of PipelineSpec, input bytes and their length, input codec
+//        ("none", "gzip", "zstd" or "auto" to sniff), output codec, and a
+//        pointer that receives the output length
+// Output: encoded CSV bytes (on success) or JSON error (on failure)
+EMSCRIPTEN_KEEPALIVE
+const char* run_pipeline_compressed(
+    const char* spec_json,
+    const char* input,
+    int input_size,
+    const char* input_codec,
+    const char* output_codec,
+    int* output_size
+) {
+    EngineContext ctx;
+    return copy_bytes_to_heap(
+        ctx.run_compressed(spec_json, input, static_cast<size_t>(input_size), input_codec, output_codec),
+        output_size
+    );
+}
+
+// ============================================
+// Batches
+// ============================================
+
+// Open a batch: one pipeline run over many inputs
+// Input: JSON string of PipelineSpec
+// Output: batch handle for batch_run / batch_close. A spec that fails to
+//         parse still yields a handle; every batch_run then reports the error.
+EMSCRIPTEN_KEEPALIVE
+void* batch_open(const char* spec_json) {
+    PipelineBatch* batch = new PipelineBatch();
     try {
-        // Parse JSON input
         json j = json::parse(spec_json);
-        PipelineSpec spec = PipelineSpec::from_json(j);
-        
-        // Validate
-        ValidationResult result = pipeline::validate_pipeline(spec);
-        
-        // Convert result to JSON string
-        std::string output = result.to_json().dump();
-        return copy_to_heap(output);
-        
+        batch->runner.reset(new BatchRunner(PipelineSpec::from_json(j)));
     } catch (const std::exception& e) {
-        // Return error as validation failure
-        json error_result = {
-            {"valid", false},
-            {"errors", {std::string("Parse error: ") + e.what()}}
-        };
-        return copy_to_heap(error_result.dump());
+        batch->error = error_json(e.what()).dump();
     }
+    return batch;
 }
 
-// Execute a pipeline on input CSV data
-// Input: JSON string of PipelineSpec, CSV string
-// Output: CSV string (on success) or JSON error (on failure)
+// Run the batch's pipeline on one input
+// Input: batch handle, input_size bytes of CSV or snapshot
+// Output: CSV string (on success) or JSON error (on failure). The result is
+//         owned by the batch and stays valid until the next batch_run or
+//         batch_close, so it must not be passed to free_result.
 EMSCRIPTEN_KEEPALIVE
-const char* run_pipeline(const char* spec_json, const char* input_csv) {
+const char* batch_run(void* handle, const char* input, int input_size) {
+    PipelineBatch* batch = static_cast<PipelineBatch*>(handle);
+    if (!batch->runner) {
+        return batch->error.c_str();
+    }
     try {
-        // Parse JSON input
-        json j = json::parse(spec_json);
-        PipelineSpec spec = PipelineSpec::from_json(j);
-        
-        // Execute pipeline
-        std::string output_csv = execute_pipeline(spec, std::string(input_csv));
-        
-        return copy_to_heap(output_csv);
-        
+        const std::string& output = batch->runner->run(input, static_cast<size_t>(input_size));
+        return output.c_str();
     } catch (const std::exception& e) {
-        // Return error as JSON
-        json error_result = {
-            {"error", true},
-            {"message", std::string("Execution error: ") + e.what()}
-        };
-        return copy_to_heap(error_result.dump());
+        batch->result = error_json(e.what()).dump();
+        return batch->result.c_str();
     }
 }
 
-// Free a result string allocated by validate_pipeline or run_pipeline
+// Close a batch handle and release everything it owns
+EMSCRIPTEN_KEEPALIVE
+void batch_close(void* handle) {
+    delete static_cast<PipelineBatch*>(handle);
+}
+
+// Free a result allocated by validate_pipeline or a run_pipeline variant
 EMSCRIPTEN_KEEPALIVE
 void free_result(const char* ptr) {
     if (ptr) {
@@ -0,0 +1,426 @@
+#include "snapshot.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace pipeline {
+
+static const char SNAPSHOT_MAGIC[7] = { '\x89', 'P', 'S', 'N', 'A', 'P', '\0' };
+static const uint8_t SNAPSHOT_VERSION = 1;
+static const uint8_t FLAG_RAGGED = 1;
+
+// Smallest encoding of a header (its length prefix) and of a cell (a string
+// offset or dictionary code), used to bound the dimensions of corrupt input
+static const uint64_t MIN_HEADER_BYTES = 4;
+static const uint64_t MIN_CELL_BYTES = 4;
+
+enum class ColumnEncoding : uint8_t {
+    String = 0,
+    Dictionary = 1,
+    Int64 = 2
+};
+
+// ============================================
+// Writing
+// ============================================
+
+static void put_u8(std::string& out, uint8_t value) {
+    out += static_cast<char>(value);
+}
+
+static void put_u32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+static void put_u64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+static void pad8(std::string& out) {
+    while (out.size() % 8 != 0) out += '\0';
+}
+
+static const std::string& cell_at(const std::vector<std::string>& row, size_t column) {
+    static const std::string empty;
+    return column < row.size() ? row[column] : empty;
+}
+
+// Integer text that formats back to itself (no '+', leading zeros or "-0")
+static bool parse_canonical_int(const std::string& s, int64_t& out) {
+    if (s.empty() || s.size() > 20) return false;
+    size_t digits = s[0] == '-' ? 1 : 0;
+    if (digits == s.size()) return false;
+    if (s[digits] == '0' && (s.size() > digits + 1 || digits == 1)) return false;
+    for (size_t i = digits; i < s.size(); i++) {
+        if (s[i] < '0' || s[i] > '9') return false;
+    }
+    errno = 0;
+    long long value = std::strtoll(s.c_str(), nullptr, 10);
+    if (errno == ERANGE) return false;
+    out = static_cast<int64_t>(value);
+    return true;
+}
+
+// Offsets are 32-bit, so one column's text is limited to 4GB
+static void put_offset(std::string& out, uint64_t offset) {
+    if (offset > UINT32_MAX) {
+        throw std::runtime_error("Snapshot column exceeds 4GB");
+    }
+    put_u32(out, static_cast<uint32_t>(offset));
+}
+
+static void write_string_column(std::string& out, const CSVData& data, size_t column) {
+    uint64_t offset = 0;
+    put_offset(out, 0);
+    for (const auto& row : data.rows) {
+        offset += cell_at(row, column).size();
+        put_offset(out, offset);
+    }
+    for (const auto& row : data.rows) {
+        out += cell_at(row, column);
+    }
+}
+
+static void write_dictionary_column(
+    std::string& out,
+    const std::vector<const std::string*>& entries,
+    const std::vector<uint32_t>& codes
+) {
+    put_u32(out, static_cast<uint32_t>(entries.size()));
+    uint64_t offset = 0;
+    put_offset(out, 0);
+    for (const std::string* entry : entries) {
+        offset += entry->size();
+        put_offset(out, offset);
+    }
+    for (const std::string* entry : entries) {
+        out += *entry;
+    }
+    pad8(out);
+    for (uint32_t code : codes) {
+        put_u32(out, code);
+    }
+}
+
+static void write_int_column(std::string& out, const std::vector<int64_t>& values, const std::vector<bool>& nulls) {
+    std::string bitmap((values.size() + 7) / 8, '\0');
+    for (size_t r = 0; r < nulls.size(); r++) {
+        if (nulls[r]) bitmap[r / 8] |= static_cast<char>(1 << (r % 8));
+    }
+    out += bitmap;
+    pad8(out);
+    for (int64_t value : values) {
+        put_u64(out, static_cast<uint64_t>(value));
+    }
+}
+
+// Pick the most compact encoding that reproduces the column exactly
+static void write_column(std::string& out, const CSVData& data, size_t column) {
+    size_t rows = data.rows.size();
+
+    // Integers
+    std::vector<int64_t> values(rows, 0);
+    std::vector<bool> nulls(rows, false);
+    bool integers = rows > 0;
+    bool any_value = false;
+    for (size_t r = 0; r < rows && integers; r++) {
+        const std::string& cell = cell_at(data.rows[r], column);
+        if (cell.empty()) {
+            nulls[r] = true;
+        } else {
+            integers = parse_canonical_int(cell, values[r]);
+            any_value = true;
+        }
+    }
+
+    // Low-cardinality strings
+    std::vector<const std::string*> entries;
+    std::vector<uint32_t> codes;
+    bool dictionary = !(integers && any_value) && rows >= 16;
+    if (dictionary) {
+        std::unordered_map<std::string, uint32_t> index;
+        codes.reserve(rows);
+        for (size_t r = 0; r < rows && dictionary; r++) {
+            const std::string& cell = cell_at(data.rows[r], column);
+            auto it = index.emplace(cell, static_cast<uint32_t>(entries.size())).first;
+            if (it->second == entries.size()) {
+                entries.push_back(&it->first);
+            }
+            codes.push_back(it->second);
+            dictionary = entries.size() * 2 <= rows;
+        }
+        if (dictionary) {
+            // entries point at the map's keys, which stay put while it lives
+            std::string body;
+            write_dictionary_column(body, entries, codes);
+            put_u8(out, static_cast<uint8_t>(ColumnEncoding::Dictionary));
+            pad8(out);
+            put_u64(out, body.size());
+            out += body;
+            pad8(out);
+            return;
+        }
+    }
+
+    std::string body;
+    ColumnEncoding encoding = ColumnEncoding::String;
+    if (integers && any_value) {
+        encoding = ColumnEncoding::Int64;
+        write_int_column(body, values, nulls);
+    } else {
+        write_string_column(body, data, column);
+    }
+    put_u8(out, static_cast<uint8_t>(encoding));
+    pad8(out);
+    put_u64(out, body.size());
+    out += body;
+    pad8(out);
+}
+
+std::string write_snapshot(const CSVData& data) {
+    size_t columns = data.headers.size();
+    bool ragged = false;
+    for (const auto& row : data.rows) {
+        if (row.size() != data.headers.size()) ragged = true;
+        if (row.size() > columns) columns = row.size();
+    }
+
+    std::string out;
+    out.append(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    put_u8(out, SNAPSHOT_VERSION);
+    put_u32(out, static_cast<uint32_t>(data.headers.size()));
+    put_u32(out, static_cast<uint32_t>(columns));
+    put_u64(out, data.rows.size());
+    put_u8(out, ragged ? FLAG_RAGGED : 0);
+    pad8(out);
+
+    for (const auto& header : data.headers) {
+        put_u32(out, static_cast<uint32_t>(header.size()));
+        out += header;
+    }
+    pad8(out);
+
+    if (ragged) {
+        for (const auto& row : data.rows) {
+            put_u32(out, static_cast<uint32_t>(row.size()));
+        }
+        pad8(out);
+    }
+
+    for (size_t c = 0; c < columns; c++) {
+        write_column(out, data, c);
+    }
+    return out;
+}
+
+// ============================================
+// Reading
+// ============================================
+
+// Bounds-checked little-endian cursor over the snapshot bytes
+class SnapshotReader {
+public:
+    SnapshotReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+    // Sizes are computed in 64 bits so corrupt counts can't wrap on wasm32
+    const char* take(uint64_t count) {
+        if (count > size_ - pos_) {
+            throw std::runtime_error("Invalid snapshot: truncated");
+        }
+        const char* p = data_ + pos_;
+        pos_ += count;
+        return p;
+    }
+
+    uint8_t u8() { return static_cast<uint8_t>(*take(1)); }
+    uint32_t u32() { return static_cast<uint32_t>(le(take(4), 4)); }
+    uint64_t u64() { return le(take(8), 8); }
+
+    size_t remaining() const { return size_ - pos_; }
+
+    void align8() {
+        size_t aligned = (pos_ + 7) & ~size_t(7);
+        take(aligned - pos_);
+    }
+
+    static uint64_t le(const char* p, size_t bytes) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+        }
+        return value;
+    }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+// Bytes [begin, end) of string i from an offsets array, checked against
+// the size of the bytes that follow it
+static std::pair<uint64_t, uint64_t> string_slice(const char* offsets, uint64_t i, uint64_t bytes) {
+    uint64_t begin = SnapshotReader::le(offsets + 4 * i, 4);
+    uint64_t end = SnapshotReader::le(offsets + 4 * (i + 1), 4);
+    if (begin > end || end > bytes) {
+        throw std::runtime_error("Invalid snapshot: bad string offsets");
+    }
+    return { begin, end };
+}
+
+// Decode one column into data.rows, which hold rows [first, first + size)
+static void read_column(SnapshotReader& in, CSVData& data, size_t column, uint64_t rows, uint64_t first) {
+    ColumnEncoding encoding = static_cast<ColumnEncoding>(in.u8());
+    in.align8();
+    uint64_t body_size = in.u64();
+    SnapshotReader body(in.take(body_size), body_size);
+    in.align8();
+
+    size_t count = data.rows.size();
+    auto assign = [&](size_t r, const char* p, size_t n) {
+        if (column < data.rows[r].size()) data.rows[r][column].assign(p, n);
+    };
+
+    switch (encoding) {
+        case ColumnEncoding::String: {
+            const char* offsets = body.take(4 * (rows + 1));
+            uint64_t total = SnapshotReader::le(offsets + 4 * rows, 4);
+            const char* bytes = body.take(total);
+            for (size_t r = 0; r < count; r++) {
+                auto slice = string_slice(offsets, first + r, total);
+                assign(r, bytes + slice.first, slice.second - slice.first);
+            }
+            return;
+        }
+        case ColumnEncoding::Dictionary: {
+            uint32_t entries = body.u32();
+            const char* offsets = body.take(4 * (uint64_t(entries) + 1));
+            uint64_t total = SnapshotReader::le(offsets + 4 * size_t(entries), 4);
+            const char* bytes = body.take(total);
+            body.align8();
+            const char* codes = body.take(4 * rows);
+            for (size_t r = 0; r < count; r++) {
+                uint64_t code = SnapshotReader::le(codes + 4 * (first + r), 4);
+                if (code >= entries) {
+                    throw std::runtime_error("Invalid snapshot: bad dictionary code");
+                }
+                auto slice = string_slice(offsets, code, total);
+                assign(r, bytes + slice.first, slice.second - slice.first);
+            }
+            return;
+        }
+        case ColumnEncoding::Int64: {
+            const char* bitmap = body.take((rows + 7) / 8);
+            body.align8();
+            const char* values = body.take(8 * rows);
+            for (size_t r = 0; r < count; r++) {
+                if (column >= data.rows[r].size()) continue;
+                uint64_t row = first + r;
+                if (bitmap[row / 8] & (1 << (row % 8))) {
+                    data.rows[r][column].clear();
+                } else {
+                    int64_t value = static_cast<int64_t>(SnapshotReader::le(values + 8 * row, 8));
+                    data.rows[r][column] = std::to_string(value);
+                }
+            }
+            return;
+        }
+    }
+    throw std::runtime_error("Invalid snapshot: unknown column encoding");
+}
+
+bool is_snapshot(const char* data, size_t size) {
+    return size >= 8 && std::memcmp(data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0;
+}
+
+// Fixed-size header fields, read up to the first header name
+struct SnapshotLayout {
+    size_t header_count;
+    size_t columns;
+    uint64_t rows;
+    uint8_t flags;
+};
+
+static SnapshotLayout read_layout(SnapshotReader& in, const char* data, size_t size) {
+    if (!is_snapshot(data, size)) {
+        throw std::runtime_error("Invalid snapshot: bad magic");
+    }
+    in.take(sizeof(SNAPSHOT_MAGIC));
+    uint8_t version = in.u8();
+    if (version != SNAPSHOT_VERSION) {
+        throw std::runtime_error("Unsupported snapshot version " + std::to_string(version));
+    }
+    SnapshotLayout layout;
+    layout.header_count = in.u32();
+    layout.columns = in.u32();
+    layout.rows = in.u64();
+    layout.flags = in.u8();
+    in.align8();
+
+    // A valid snapshot's dimensions fit in the bytes left (an Int64 cell
+    // takes eight), which caps the allocations made for corrupt input
+    uint64_t remaining = in.remaining();
+    if (layout.columns < layout.header_count ||
+        layout.header_count > remaining / MIN_HEADER_BYTES ||
+        (layout.columns == 0 && layout.rows > 0) ||
+        (layout.columns > 0 && layout.rows > remaining / MIN_CELL_BYTES / layout.columns)) {
+        throw std::runtime_error("Invalid snapshot: bad dimensions");
+    }
+    return layout;
+}
+
+uint64_t snapshot_row_count(const char* data, size_t size) {
+    SnapshotReader in(data, size);
+    return read_layout(in, data, size).rows;
+}
+
+CSVData read_snapshot(const char* data, size_t size) {
+    return read_snapshot(data, size, 0, UINT64_MAX);
+}
+
+CSVData read_snapshot(const char* data, size_t size, uint64_t first_row, uint64_t row_count) {
+    SnapshotReader in(data, size);
+    SnapshotLayout layout = read_layout(in, data, size);
+    uint64_t rows = layout.rows;
+    uint64_t first = std::min(first_row, rows);
+    uint64_t count = std::min(row_count, rows - first);
+
+    CSVData result;
+    result.headers.reserve(layout.header_count);
+    for (size_t i = 0; i < layout.header_count; i++) {
+        uint32_t length = in.u32();
+        result.headers.emplace_back(in.take(length), length);
+    }
+    in.align8();
+
+    result.rows.resize(count);
+    if (layout.flags & FLAG_RAGGED) {
+        const char* lengths = in.take(4 * rows);
+        for (size_t r = 0; r < count; r++) {
+            size_t length = SnapshotReader::le(lengths + 4 * (first + r), 4);
+            if (length > layout.columns) {
+                throw std::runtime_error("Invalid snapshot: bad row length");
+            }
+            result.rows[r].resize(length);
+        }
+        in.align8();
+    } else {
+        for (auto& row : result.rows) {
+            row.resize(layout.header_count);
+        }
+    }
+
+    for (size_t c = 0; c < layout.columns; c++) {
+        read_column(in, result, c, rows, first);
+    }
+    return result;
+}
+
+} // namespace pipeline
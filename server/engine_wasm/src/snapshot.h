@@ -0,0 +1,51 @@
+#ifndef PIPELINE_SNAPSHOT_H
+#define PIPELINE_SNAPSHOT_H
+
+#include "types.h"
+#include <string>
+
+namespace pipeline {
+
+// Binary columnar snapshot of a parsed dataset, so reruns skip CSV parsing.
+//
+// Layout (little-endian, every section starts on an 8-byte boundary so a
+// memory-mapped snapshot can be read in place):
+//   magic      "\x89PSNAP\0" + format version byte
+//   u32        header count
+//   u32        column count (widest row; equals the header count unless ragged)
+//   u64        row count
+//   u8         flags (bit 0: rows have differing lengths)
+//   headers    u32 length + bytes, per header
+//   [lengths]  u32 per row, only when ragged
+//   columns    u8 encoding, u64 body size, then the body:
+//                String:     u32 offsets[rows + 1], bytes
+//                Dictionary: u32 entries, u32 offsets[entries + 1], bytes,
+//                            u32 codes[rows]
+//                Int64:      null bitmap (empty cells), i64 values[rows]
+//
+// Integer columns are only typed when every value round-trips to the exact
+// same text, so loading a snapshot reproduces the original cells.
+//
+// Decoding still copies every cell into the row strings; what a snapshot
+// saves over parse_csv is the scan for quotes, delimiters and newlines.
+
+// Check the magic bytes
+bool is_snapshot(const char* data, size_t size);
+
+// Encode a dataset as a snapshot
+std::string write_snapshot(const CSVData& data);
+
+// Decode a snapshot (e.g. straight out of a memory mapping)
+// Throws std::runtime_error on malformed or unsupported input
+CSVData read_snapshot(const char* data, size_t size);
+
+// Decode only rows [first_row, first_row + row_count), clamped to the rows
+// the snapshot holds; other rows' cells are not touched
+CSVData read_snapshot(const char* data, size_t size, uint64_t first_row, uint64_t row_count);
+
+// Row count of a snapshot, without decoding it
+uint64_t snapshot_row_count(const char* data, size_t size);
+
+} // namespace pipeline
+
+#endif // PIPELINE_SNAPSHOT_H
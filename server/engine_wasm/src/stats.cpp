@@ -0,0 +1,225 @@
+#include "stats.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+
+namespace pipeline {
+
+// ============================================
+// HyperLogLog
+// ============================================
+
+// 64-bit FNV-1a followed by a splitmix64 finalizer for well-mixed bits
+static uint64_t hash_bytes(const char* data, size_t size) {
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < size; i++) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ULL;
+    }
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+void HyperLogLog::add(const char* data, size_t size) {
+    uint64_t h = hash_bytes(data, size);
+    size_t index = static_cast<size_t>(h >> (64 - PRECISION));
+    uint64_t rest = (h << PRECISION) | (uint64_t(1) << (PRECISION - 1));
+    
+    // Rank = position of the first set bit in the remaining bits
+    uint8_t rank = 1;
+    while (!(rest & (uint64_t(1) << 63))) {
+        rest <<= 1;
+        rank++;
+    }
+    if (rank > registers_[index]) {
+        registers_[index] = rank;
+    }
+}
+
+double HyperLogLog::estimate() const {
+    const double m = static_cast<double>(REGISTERS);
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t r : registers_) {
+        sum += std::ldexp(1.0, -r);
+        if (r == 0) zeros++;
+    }
+    
+    double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    
+    // Small range correction: linear counting
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / static_cast<double>(zeros));
+    }
+    return estimate;
+}
+
+// ============================================
+// Type Inference
+// ============================================
+
+static bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static bool is_integer_text(const std::string& s) {
+    size_t i = (s[0] == '-' || s[0] == '+') ? 1 : 0;
+    if (i == s.size()) return false;
+    for (; i < s.size(); i++) {
+        if (!is_digit(s[i])) return false;
+    }
+    return true;
+}
+
+static bool parse_integer_text(const std::string& s, int64_t& out) {
+    if (!is_integer_text(s)) return false;
+    errno = 0;
+    out = std::strtoll(s.c_str(), nullptr, 10);
+    return errno != ERANGE;
+}
+
+// Plain decimal notation only: [+-]digits[.digits][e[+-]digits]. strtod on
+// its own also takes leading spaces, hex, inf and nan, which the executor's
+// numeric filters (std::stod) reject or read differently, so only values
+// the filters compare as the same number are counted as numbers
+static bool parse_number_text(const std::string& s, double& out) {
+    size_t i = (s[0] == '-' || s[0] == '+') ? 1 : 0;
+    size_t digits = 0;
+    while (i < s.size() && is_digit(s[i])) { i++; digits++; }
+    if (i < s.size() && s[i] == '.') {
+        i++;
+        while (i < s.size() && is_digit(s[i])) { i++; digits++; }
+    }
+    if (digits == 0) return false;
+    if (i < s.size() && (s[i] == 'e' || s[i] == 'E')) {
+        i++;
+        if (i < s.size() && (s[i] == '-' || s[i] == '+')) i++;
+        size_t exponent_digits = 0;
+        while (i < s.size() && is_digit(s[i])) { i++; exponent_digits++; }
+        if (exponent_digits == 0) return false;
+    }
+    if (i != s.size()) return false;
+    
+    // Out-of-range values make std::stod throw, so the executor skips them
+    errno = 0;
+    out = std::strtod(s.c_str(), nullptr);
+    return errno != ERANGE;
+}
+
+static bool is_boolean_text(const std::string& s) {
+    return s == "true" || s == "false" || s == "TRUE" || s == "FALSE" || s == "True" || s == "False";
+}
+
+// ISO dates: YYYY-MM-DD
+static bool is_date_text(const std::string& s) {
+    if (s.size() != 10 || s[4] != '-' || s[7] != '-') return false;
+    for (size_t i : {0, 1, 2, 3, 5, 6, 8, 9}) {
+        if (s[i] < '0' || s[i] > '9') return false;
+    }
+    int month = (s[5] - '0') * 10 + (s[6] - '0');
+    int day = (s[8] - '0') * 10 + (s[9] - '0');
+    return month >= 1 && month <= 12 && day >= 1 && day <= 31;
+}
+
+// ============================================
+// Collector
+// ============================================
+
+ColumnStatsCollector::ColumnStatsCollector(const std::vector<std::string>& headers)
+    : headers_(headers), columns_(headers.size()) {}
+
+void ColumnStatsCollector::add_row(const std::vector<std::string>& row) {
+    for (size_t i = 0; i < columns_.size(); i++) {
+        if (i < row.size()) {
+            add_cell(columns_[i], row[i]);
+        } else {
+            columns_[i].null_count++;
+        }
+    }
+}
+
+void ColumnStatsCollector::add_cell(Column& column, const std::string& cell) {
+    if (cell.empty()) {
+        column.null_count++;
+        return;
+    }
+    
+    bool first = column.non_null++ == 0;
+    column.distinct.add(cell.data(), cell.size());
+    
+    if (column.types & IS_INTEGER) {
+        // Tracked exactly: doubles lose precision above 2^53
+        int64_t integer = 0;
+        if (parse_integer_text(cell, integer)) {
+            if (first || integer < column.min_integer) column.min_integer = integer;
+            if (first || integer > column.max_integer) column.max_integer = integer;
+        } else {
+            column.types &= ~IS_INTEGER;
+        }
+    }
+    if (column.types & IS_NUMBER) {
+        double number = 0;
+        if (parse_number_text(cell, number)) {
+            if (first || number < column.min_number) column.min_number = number;
+            if (first || number > column.max_number) column.max_number = number;
+        } else {
+            column.types &= ~(IS_NUMBER | IS_INTEGER);
+        }
+    }
+    if (column.types & IS_BOOLEAN) {
+        if (!is_boolean_text(cell)) column.types &= ~IS_BOOLEAN;
+    }
+    if (column.types & IS_DATE) {
+        if (!is_date_text(cell)) column.types &= ~IS_DATE;
+    }
+    
+    if (first || cell < column.min_text) column.min_text = cell;
+    if (first || cell > column.max_text) column.max_text = cell;
+}
+
+std::vector<ColumnStats> ColumnStatsCollector::finish() const {
+    std::vector<ColumnStats> result;
+    result.reserve(columns_.size());
+    
+    for (size_t i = 0; i < columns_.size(); i++) {
+        const Column& column = columns_[i];
+        ColumnStats stats;
+        stats.name = headers_[i];
+        stats.null_count = column.null_count;
+        stats.distinct_estimate = column.non_null == 0
+            ? 0
+            : static_cast<size_t>(std::llround(std::min(column.distinct.estimate(), double(column.non_null))));
+        
+        if (column.non_null == 0) {
+            stats.type = "empty";
+        } else if (column.types & (IS_INTEGER | IS_NUMBER)) {
+            if (column.types & IS_INTEGER) {
+                stats.type = "integer";
+                stats.min = column.min_integer;
+                stats.max = column.max_integer;
+            } else {
+                stats.type = "number";
+                stats.min = column.min_number;
+                stats.max = column.max_number;
+            }
+        } else {
+            if (column.types & IS_BOOLEAN) stats.type = "boolean";
+            else if (column.types & IS_DATE) stats.type = "date";
+            else stats.type = "string";
+            stats.min = column.min_text;
+            stats.max = column.max_text;
+        }
+        
+        result.push_back(std::move(stats));
+    }
+    
+    return result;
+}
+
+} // namespace pipeline
@@ -0,0 +1,62 @@
+#ifndef PIPELINE_STATS_H
+#define PIPELINE_STATS_H
+
+#include "types.h"
+#include <array>
+#include <cstdint>
+
+namespace pipeline {
+
+// HyperLogLog distinct-count estimator (2^12 registers, ~1.6% error)
+class HyperLogLog {
+public:
+    void add(const char* data, size_t size);
+    double estimate() const;
+
+private:
+    static const int PRECISION = 12;
+    static const size_t REGISTERS = size_t(1) << PRECISION;
+    std::array<uint8_t, REGISTERS> registers_{};
+};
+
+// Accumulates column statistics row by row (fed by the serializer, so the
+// output is only walked once)
+class ColumnStatsCollector {
+public:
+    explicit ColumnStatsCollector(const std::vector<std::string>& headers);
+
+    void add_row(const std::vector<std::string>& row);
+
+    std::vector<ColumnStats> finish() const;
+
+private:
+    // Candidate types a column can still be; cleared as values disagree
+    enum TypeBits : uint8_t {
+        IS_INTEGER = 1,
+        IS_NUMBER = 2,
+        IS_BOOLEAN = 4,
+        IS_DATE = 8
+    };
+
+    struct Column {
+        size_t null_count = 0;
+        size_t non_null = 0;
+        uint8_t types = IS_INTEGER | IS_NUMBER | IS_BOOLEAN | IS_DATE;
+        int64_t min_integer = 0;
+        int64_t max_integer = 0;
+        double min_number = 0;
+        double max_number = 0;
+        std::string min_text;
+        std::string max_text;
+        HyperLogLog distinct;
+    };
+
+    void add_cell(Column& column, const std::string& cell);
+
+    std::vector<std::string> headers_;
+    std::vector<Column> columns_;
+};
+
+} // namespace pipeline
+
+#endif // PIPELINE_STATS_H
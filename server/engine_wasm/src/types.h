@@ -5,6 +5,8 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <functional>
+#include <cstdint>
 #include "../lib/json.hpp"
 
 using json = nlohmann::json;
@@ -24,6 +26,11 @@ const std::set<std::string> VALID_OPS = {
     "output_csv"
 };
 
+// Operations that need their whole input before emitting any row.
+// Preview runs fall back to sampling when a pipeline contains one; every
+// current operation streams (dedupe keeps the first occurrence of a key).
+const std::set<std::string> BLOCKING_OPS = {};
+
 // Pipeline node structure
 struct PipelineNode {
     std::string id;
@@ -56,15 +63,121 @@ struct PipelineSpec {
     }
 };
 
+// Preview execution options
+struct PreviewOptions {
+    size_t limit = 100;       // Maximum number of output rows
+    bool sample = false;      // Reservoir sample instead of the first rows
+    uint64_t seed = 42;       // Fixed seed so samples are reproducible
+    
+    static PreviewOptions from_json(const json& j) {
+        PreviewOptions options;
+        options.limit = j.value("limit", options.limit);
+        options.sample = j.value("mode", std::string("head")) == "sample";
+        options.seed = j.value("seed", options.seed);
+        return options;
+    }
+};
+
+// Per-node execution statistics
+struct NodeStats {
+    std::string id;
+    std::string op;
+    double time_ms = 0;
+    size_t rows_out = 0;
+    
+    json to_json() const {
+        return json{
+            {"id", id},
+            {"op", op},
+            {"time_ms", time_ms},
+            {"rows_out", rows_out}
+        };
+    }
+};
+
+// Statistics for one output column
+struct ColumnStats {
+    std::string name;
+    size_t null_count = 0;          // empty cells
+    size_t distinct_estimate = 0;   // HyperLogLog estimate over non-empty cells
+    std::string type;               // integer, number, boolean, date, string or empty
+    json min;                       // numeric for integer/number columns, otherwise text
+    json max;
+    
+    json to_json() const {
+        return json{
+            {"name", name},
+            {"null_count", null_count},
+            {"distinct_estimate", distinct_estimate},
+            {"type", type},
+            {"min", min},
+            {"max", max}
+        };
+    }
+};
+
+// Measurements behind the evaluation order of one filter
+struct FilterStats {
+    std::string id;
+    double selectivity = 0;     // fraction of sampled rows kept
+    double cost_ns = 0;         // evaluation time per sampled row
+    
+    json to_json() const {
+        return json{
+            {"id", id},
+            {"selectivity", selectivity},
+            {"cost_ns", cost_ns}
+        };
+    }
+};
+
+// Statistics collected while running a pipeline
+struct RunStats {
+    std::vector<NodeStats> nodes;
+    size_t input_rows = 0;
+    size_t output_rows = 0;
+    std::vector<ColumnStats> columns;
+    // Per group of consecutive filters, the filters in the order they ran
+    std::vector<std::vector<FilterStats>> filter_order;
+    
+    json to_json() const {
+        json nodes_json = json::array();
+        for (const auto& node : nodes) {
+            nodes_json.push_back(node.to_json());
+        }
+        json columns_json = json::array();
+        for (const auto& column : columns) {
+            columns_json.push_back(column.to_json());
+        }
+        json filter_order_json = json::array();
+        for (const auto& group : filter_order) {
+            json group_json = json::array();
+            for (const auto& filter : group) {
+                group_json.push_back(filter.to_json());
+            }
+            filter_order_json.push_back(group_json);
+        }
+        return json{
+            {"nodes", nodes_json},
+            {"input_rows", input_rows},
+            {"output_rows", output_rows},
+            {"columns", columns_json},
+            {"filter_order", filter_order_json}
+        };
+    }
+};
+
 // Validation result
 struct ValidationResult {
     bool valid;
     std::vector<std::string> errors;
+    std::vector<std::string> warnings;  // accepted, but likely not what was meant
     
     json to_json() const {
         return json{
             {"valid", valid},
-            {"errors", errors}
+            {"errors", errors},
+            {"warnings", warnings}
         };
     }
 };
@@ -93,9 +206,26 @@ struct CSVData {
     }
 };
 
+// Receives bytes in chunks (streamed input or serialized output)
+using ByteSink = std::function<void(const char* data, size_t size)>;
+
 // Record representation (for easier manipulation)
 using Record = std::map<std::string, std::string>;
 
+// Selection vector: indices of the live records, in output order.
+// Filter and dedupe narrow the selection instead of erasing records, so
+// surviving rows are only moved once, when the output is materialized.
+using SelectionVector = std::vector<size_t>;
+
+// Selection covering every record
+inline SelectionVector select_all(size_t count) {
+    SelectionVector selection(count);
+    for (size_t i = 0; i < count; i++) {
+        selection[i] = i;
+    }
+    return selection;
+}
+
 // Convert CSVData to vector of Records
 inline std::vector<Record> csv_to_records(const CSVData& csv) {
     std::vector<Record> records;
@@ -126,6 +256,30 @@ inline CSVData records_to_csv(const std::vector<Record>& records, const std::vec
     return csv;
 }
 
+// Convert the selected Records back to CSVData (late materialization)
+inline CSVData records_to_csv(
+    const std::vector<Record>& records,
+    const SelectionVector& selection,
+    const std::vector<std::string>& headers
+) {
+    CSVData csv;
+    csv.headers = headers;
+    csv.rows.reserve(selection.size());
+    
+    for (size_t idx : selection) {
+        const Record& record = records[idx];
+        std::vector<std::string> row;
+        row.reserve(headers.size());
+        for (const auto& header : headers) {
+            auto it = record.find(header);
+            row.push_back(it != record.end() ? it->second : "");
+        }
+        csv.rows.push_back(std::move(row));
+    }
+    
+    return csv;
+}
+
 } // namespace pipeline
 
 #endif // PIPELINE_TYPES_H
@@ -1,10 +1,15 @@
 #include "validator.h"
+#include "expression.h"
 #include <algorithm>
 
 namespace pipeline {
 
 // Validate node-specific configuration
-static void validate_node_config(const PipelineNode& node, std::vector<std::string>& errors) {
+static void validate_node_config(
+    const PipelineNode& node,
+    std::vector<std::string>& errors,
+    std::vector<std::string>& warnings
+) {
     const auto& config = node.config;
     
     if (node.op == "select_columns") {
@@ -33,6 +38,14 @@ static void validate_node_config(const PipelineNode& node, std::vector<std::stri
         }
         if (!config.contains("expression") || !config["expression"].is_string()) {
             errors.push_back("Node " + node.id + ": transform requires 'expression' string");
+        } else {
+            // The executor skips transforms it can't compile, and stored
+            // specs rely on that, so this is a warning rather than an error
+            try {
+                Expression::compile(config["expression"].get<std::string>());
+            } catch (const std::exception& e) {
+                warnings.push_back("Node " + node.id + ": transform expression is skipped: " + e.what());
+            }
         }
     }
     else if (node.op == "validate_email") {
@@ -102,7 +115,7 @@ ValidationResult validate_pipeline(const PipelineSpec& spec) {
         }
         
         // Validate operation-specific config
-        validate_node_config(node, result.errors);
+        validate_node_config(node, result.errors, result.warnings);
     }
     
     // Check that pipeline starts with parse_csv
@@ -0,0 +1,131 @@
+// Snapshot round-trip and corrupt-input tests (make test)
+
+#include "snapshot.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+using namespace pipeline;
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+static bool rejects(const std::string& snapshot) {
+    try {
+        read_snapshot(snapshot.data(), snapshot.size());
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+static CSVData sample() {
+    CSVData data;
+    data.headers = { "id", "city", "note" };
+    for (int i = 0; i < 50; i++) {
+        data.rows.push_back({ std::to_string(i), i % 2 ? "Oslo" : "Lima", "row " + std::to_string(i) });
+    }
+    data.rows.push_back({ "", "Oslo" });
+    data.rows.push_back({ "007", "Lima", "x", "extra" });
+    return data;
+}
+
+static void put_u32(std::string& s, size_t at, uint32_t v) {
+    for (int i = 0; i < 4; i++) s[at + i] = static_cast<char>((v >> (8 * i)) & 0xff);
+}
+
+static void put_u64(std::string& s, size_t at, uint64_t v) {
+    for (int i = 0; i < 8; i++) s[at + i] = static_cast<char>((v >> (8 * i)) & 0xff);
+}
+
+// Field offsets in the fixed layout header
+static const size_t HEADER_COUNT_AT = 8;
+static const size_t COLUMNS_AT = 12;
+static const size_t ROWS_AT = 16;
+
+static void test_round_trip() {
+    CSVData data = sample();
+    std::string snapshot = write_snapshot(data);
+    CSVData loaded = read_snapshot(snapshot.data(), snapshot.size());
+    CHECK(loaded.headers == data.headers);
+    CHECK(loaded.rows == data.rows);
+    CHECK(snapshot_row_count(snapshot.data(), snapshot.size()) == data.rows.size());
+
+    CSVData slice = read_snapshot(snapshot.data(), snapshot.size(), 10, 5);
+    CHECK(slice.rows.size() == 5);
+    CHECK(slice.rows.size() == 5 && slice.rows[0] == data.rows[10]);
+}
+
+static void test_truncated() {
+    std::string snapshot = write_snapshot(sample());
+    for (size_t size = 0; size < snapshot.size(); size++) {
+        if (!rejects(snapshot.substr(0, size))) {
+            std::fprintf(stderr, "truncation to %zu bytes was accepted\n", size);
+            failures++;
+        }
+    }
+}
+
+static void test_huge_dimensions() {
+    std::string snapshot = write_snapshot(sample());
+
+    std::string headers = snapshot;
+    put_u32(headers, HEADER_COUNT_AT, 0xffffffffu);
+    put_u32(headers, COLUMNS_AT, 0xffffffffu);
+    CHECK(rejects(headers));
+
+    std::string rows = snapshot;
+    put_u64(rows, ROWS_AT, uint64_t(1) << 40);
+    CHECK(rejects(rows));
+
+    // Just past what the bytes left could hold at four bytes per cell
+    std::string wide = snapshot;
+    put_u64(wide, ROWS_AT, snapshot.size() / 4 / 3 + 1);
+    CHECK(rejects(wide));
+
+    std::string columns = snapshot;
+    put_u32(columns, COLUMNS_AT, 0x10000000u);
+    CHECK(rejects(columns));
+
+    std::string empty = snapshot;
+    put_u32(empty, HEADER_COUNT_AT, 0);
+    put_u32(empty, COLUMNS_AT, 0);
+    CHECK(rejects(empty));
+}
+
+// Random corruption must be rejected or decoded, never crash
+static void test_bit_flips() {
+    std::string snapshot = write_snapshot(sample());
+    std::mt19937 rng(1234);
+    for (int round = 0; round < 20000; round++) {
+        std::string corrupt = snapshot;
+        int flips = 1 + static_cast<int>(rng() % 4);
+        for (int i = 0; i < flips; i++) {
+            corrupt[rng() % corrupt.size()] ^= static_cast<char>(1 + rng() % 255);
+        }
+        rejects(corrupt);
+    }
+}
+
+int main() {
+    test_round_trip();
+    test_truncated();
+    test_huge_dimensions();
+    test_bit_flips();
+
+    if (failures > 0) {
+        std::fprintf(stderr, "%d snapshot check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("snapshot tests passed\n");
+    return 0;
+}
@@ -5,17 +5,26 @@ import { pipelinesRoutes } from "./routes/pipelines";
 import { runsRoutes } from "./routes/runs";
 import { pipelineRunRoutes } from "./routes/pipeline-run";
 import { exportDockerRoutes } from "./routes/export-docker";
-import { loadWasmEngine, isWasmLoaded } from "../engine_wasm/bindings";
+import { loadWasmEngine, isWasmLoaded, startEnginePool, enginePoolSize } from "../engine_wasm/bindings";
+import { snapshotCacheSize } from "./lib/snapshot-cache";
 
 // Try to load WASM engine (falls back to TypeScript if unavailable)
 await loadWasmEngine();
 
+// Run pipelines on a pool of engine instances so concurrent requests
+// don't serialize on the event loop
+if (isWasmLoaded()) {
+  await startEnginePool();
+}
+
 const app = new Elysia()
   .use(cors())
   .get("/health", () => ({ 
     status: "ok", 
     timestamp: new Date().toISOString(),
     wasm_loaded: isWasmLoaded(),
+    engine_workers: enginePoolSize(),
+    snapshot_cache: snapshotCacheSize(),
   }))
   .use(runRoutes)
   .use(pipelinesRoutes)
@@ -28,5 +37,6 @@ console.log(
   `🚀 Dagger server running at http://${app.server?.hostname}:${app.server?.port}`
 );
 console.log(`   WASM engine: ${isWasmLoaded() ? "loaded" : "using TypeScript fallback"}`);
+console.log(`   Engine workers: ${enginePoolSize() || "none (running inline)"}`);
 
 export type App = typeof app;
@@ -1,3 +1,4 @@
+import { gunzipSync, gzipSync } from "node:zlib";
 import type { ParsedCSV } from "./types";
 
 // ============================================
@@ -20,6 +21,47 @@ export function bytesToBase64(bytes: Uint8Array): string {
   return Buffer.from(bytes).toString("base64");
 }
 
+// ============================================
+// Compressed Payloads
+// ============================================
+
+function isGzip(bytes: Uint8Array): boolean {
+  return bytes.length >= 2 && bytes[0] === 0x1f && bytes[1] === 0x8b;
+}
+
+// Uploaded CSV bytes, inflated when the upload is gzip-compressed.
+// Inflating stops once the output passes maxBytes, so a small upload can't
+// expand past the input limit.
+export function decodeCSVBytes(base64: string, maxBytes: number): Uint8Array {
+  const bytes = base64ToBytes(base64);
+  if (!isGzip(bytes)) {
+    return bytes;
+  }
+  try {
+    return gunzipSync(bytes, { maxOutputLength: maxBytes + 1 });
+  } catch (error) {
+    if ((error as NodeJS.ErrnoException).code === "ERR_BUFFER_TOO_LARGE") {
+      throw new Error(`Input too large: more than ${maxBytes} bytes once decompressed`);
+    }
+    throw error;
+  }
+}
+
+export function decodeCSVPayload(base64: string, maxBytes: number): string {
+  return Buffer.from(decodeCSVBytes(base64, maxBytes)).toString("utf-8");
+}
+
+// Run outputs are stored gzip-compressed (base64 of the gzip bytes).
+// Runs stored before that hold plain CSV, which decodes unchanged.
+export function encodeStoredOutput(csvContent: string): string {
+  return bytesToBase64(gzipSync(Buffer.from(csvContent, "utf-8")));
+}
+
+export function decodeStoredOutput(stored: string): string {
+  const bytes = base64ToBytes(stored);
+  return isGzip(bytes) ? bytesToBase64(gunzipSync(bytes)) : stored;
+}
+
 // ============================================
 // CSV Parsing
 // ============================================
@@ -44,6 +86,25 @@ export function parseCSV(csvContent: string, delimiter: string = ","): ParsedCSV
   return { headers, rows };
 }
 
+// Header names only, without parsing the rows (for inputs the engine parses)
+export function parseCSVHeader(csvContent: string, delimiter: string = ","): string[] {
+  const content = csvContent.trimStart();
+  const end = content.search(/\r?\n/);
+  return parseCSVLine(end === -1 ? content : content.slice(0, end), delimiter);
+}
+
+// Row count parseCSV would report, without splitting the fields
+export function countCSVRows(csvContent: string): number {
+  const lines = csvContent.trim().split(/\r?\n/);
+  let rows = 0;
+  for (let i = 1; i < lines.length; i++) {
+    if (lines[i].trim()) {
+      rows++;
+    }
+  }
+  return rows;
+}
+
 function parseCSVLine(line: string, delimiter: string): string[] {
   const result: string[] = [];
   let current = "";
@@ -1,38 +1,47 @@
-import type { ParsedCSV, PipelineSpec, RunMetrics, RunEval } from "./types";
+import type { ParsedCSV, PipelineSpec, RunMetrics, RunEval, EngineRunStats } from "./types";
 
 // ============================================
 // Metrics Computation
 // ============================================
 
 export function computeMetrics(
-  inputCSV: ParsedCSV,
+  inputRows: number,
   outputCSV: ParsedCSV,
-  execTimeMs: number
+  execTimeMs: number,
+  stats?: EngineRunStats
 ): RunMetrics {
-  const inputRows = inputCSV.rows.length;
-  const outputRows = outputCSV.rows.length;
+  return {
+    input_rows: stats?.input_rows ?? inputRows,
+    output_rows: stats?.output_rows ?? outputCSV.rows.length,
+    null_rate: outputNullRate(outputCSV, stats),
+    exec_time_ms: execTimeMs,
+    columns: stats?.columns,
+  };
+}
 
-  // Calculate null rate in output
+// Fraction of empty output cells. Uses the engine's column statistics when
+// available instead of walking every cell.
+function outputNullRate(outputCSV: ParsedCSV, stats?: EngineRunStats): number {
   let nullCount = 0;
   let totalCells = 0;
 
-  for (const row of outputCSV.rows) {
-    for (const cell of row) {
-      totalCells++;
-      if (cell === "" || cell === null || cell === undefined) {
-        nullCount++;
+  if (stats) {
+    for (const column of stats.columns) {
+      nullCount += column.null_count;
+    }
+    totalCells = stats.output_rows * stats.columns.length;
+  } else {
+    for (const row of outputCSV.rows) {
+      for (const cell of row) {
+        totalCells++;
+        if (cell === "" || cell === null || cell === undefined) {
+          nullCount++;
+        }
       }
     }
   }
 
-  const nullRate = totalCells > 0 ? nullCount / totalCells : 0;
-
-  return {
-    input_rows: inputRows,
-    output_rows: outputRows,
-    null_rate: nullRate,
-    exec_time_ms: execTimeMs,
-  };
+  return totalCells > 0 ? nullCount / totalCells : 0;
 }
 
 // ============================================
@@ -41,12 +50,13 @@ export function computeMetrics(
 
 export function evaluateRun(
   spec: PipelineSpec,
-  inputCSV: ParsedCSV,
+  inputRows: number,
   outputCSV: ParsedCSV,
-  validationErrors: string[]
+  validationErrors: string[],
+  stats?: EngineRunStats
 ): RunEval {
   const schemaMatch = checkSchemaMatch(spec, outputCSV);
-  const constraintPass = checkConstraints(spec, inputCSV, outputCSV);
+  const constraintPass = checkConstraints(spec, inputRows, outputCSV, stats);
   const execSuccess = validationErrors.length === 0 && outputCSV.rows.length > 0;
 
   // Calculate overall score (0-1)
@@ -92,8 +102,9 @@ function checkSchemaMatch(spec: PipelineSpec, outputCSV: ParsedCSV): boolean {
 
 function checkConstraints(
   spec: PipelineSpec,
-  inputCSV: ParsedCSV,
-  outputCSV: ParsedCSV
+  inputRows: number,
+  outputCSV: ParsedCSV,
+  stats?: EngineRunStats
 ): boolean {
   // Check dedupe constraint: after dedupe, key columns should be unique
   const dedupeNode = spec.nodes.find((n) => n.op === "dedupe");
@@ -120,23 +131,12 @@ function checkConstraints(
 
   // Check that output has data (unless filter could legitimately remove all)
   const hasFilter = spec.nodes.some((n) => n.op === "filter");
-  if (!hasFilter && inputCSV.rows.length > 0 && outputCSV.rows.length === 0) {
+  if (!hasFilter && inputRows > 0 && outputCSV.rows.length === 0) {
     return false;
   }
 
   // Check null rate threshold (max 20% nulls in output)
-  let nullCount = 0;
-  let totalCells = 0;
-  for (const row of outputCSV.rows) {
-    for (const cell of row) {
-      totalCells++;
-      if (cell === "" || cell === null || cell === undefined) {
-        nullCount++;
-      }
-    }
-  }
-  const nullRate = totalCells > 0 ? nullCount / totalCells : 0;
-  if (nullRate > 0.2) {
+  if (outputNullRate(outputCSV, stats) > 0.2) {
     return false;
   }
 
@@ -51,7 +51,7 @@ Available operations:
 - select_columns: Keep only specified columns. Config: { "columns": ["col1", "col2"] }
 - dedupe: Remove duplicate rows. Config: { "key_columns": ["col1", "col2"] }
 - rename_columns: Rename columns. Config: { "mapping": { "old_name": "new_name" } }
-- transform: Apply transformation. Config: { "column": "col_name", "expression": "lower(value)" }
+- transform: Apply transformation. Config: { "column": "col_name", "expression": "lower(value)" }. Functions compose, e.g. "lower(trim(value))": lower, upper, trim, ltrim, rtrim, title, digits, replace(x, 'old', 'new'), substr(x, start, length), left(x, n), right(x, n), concat(x, y, ...), coalesce(x, y, ...)
 - validate_email: Validate email format. Config: { "column": "email", "strict": true }
 - fix_dates: Standardize date format. Config: { "column": "date_col", "format": "YYYY-MM-DD" }
 - output_csv: Output as CSV. Config: { "delimiter": "," }
@@ -0,0 +1,47 @@
+// ============================================
+// Snapshot Cache
+// ============================================
+// Columnar snapshots of recently run inputs, keyed by input hash, so a
+// re-run on data the engine has already seen skips CSV parsing. Evicts the
+// least recently used snapshots once the byte budget is exceeded.
+
+const MAX_CACHE_BYTES = parseInt(process.env.SNAPSHOT_CACHE_BYTES || "268435456", 10); // 256MB default
+
+const snapshots = new Map<string, Uint8Array>();
+let cachedBytes = 0;
+
+export function getSnapshot(inputHash: string): Uint8Array | undefined {
+  const snapshot = snapshots.get(inputHash);
+  if (snapshot) {
+    // Re-insert to mark as most recently used
+    snapshots.delete(inputHash);
+    snapshots.set(inputHash, snapshot);
+  }
+  return snapshot;
+}
+
+export function putSnapshot(inputHash: string, snapshot: Uint8Array): void {
+  if (snapshot.length > MAX_CACHE_BYTES) {
+    return;
+  }
+
+  const existing = snapshots.get(inputHash);
+  if (existing) {
+    cachedBytes -= existing.length;
+    snapshots.delete(inputHash);
+  }
+
+  snapshots.set(inputHash, snapshot);
+  cachedBytes += snapshot.length;
+
+  // Map iteration order is insertion order, oldest first
+  for (const [hash, entry] of snapshots) {
+    if (cachedBytes <= MAX_CACHE_BYTES) break;
+    snapshots.delete(hash);
+    cachedBytes -= entry.length;
+  }
+}
+
+export function snapshotCacheSize(): { entries: number; bytes: number } {
+  return { entries: snapshots.size, bytes: cachedBytes };
+}
@@ -90,6 +90,40 @@ export interface RunMetrics {
   output_rows: number;
   null_rate?: number;
   exec_time_ms: number;
+  columns?: ColumnStats[];
+}
+
+// Per-column statistics gathered by the engine while serializing output
+export interface ColumnStats {
+  name: string;
+  null_count: number;
+  distinct_estimate: number;
+  type: "integer" | "number" | "boolean" | "date" | "string" | "empty";
+  min: number | string | null;
+  max: number | string | null;
+}
+
+export interface NodeRunStats {
+  id: string;
+  op: PipelineOp;
+  time_ms: number;
+  rows_out: number;
+}
+
+// Measurements behind the evaluation order of one filter
+export interface FilterRunStats {
+  id: string;
+  selectivity: number; // fraction of sampled rows kept
+  cost_ns: number; // evaluation time per sampled row
+}
+
+export interface EngineRunStats {
+  nodes: NodeRunStats[];
+  input_rows: number;
+  output_rows: number;
+  columns: ColumnStats[];
+  // Per group of consecutive filters, the filters in the order they ran
+  filter_order: FilterRunStats[][];
 }
 
 // ============================================
@@ -231,6 +265,46 @@ export interface RerunPipelineResponse {
   };
 }
 
+export interface PreviewPipelineRequest {
+  pipeline_version_id: string;
+  data: {
+    format: "csv";
+    content_base64: string;
+  };
+  options?: {
+    limit?: number;
+    mode?: "head" | "sample";
+    seed?: number;
+  };
+}
+
+export interface PreviewPipelineResponse {
+  output: ParsedCSV;
+  exec_time_ms: number;
+}
+
+export interface BatchPipelineRequest {
+  pipeline_version_id: string;
+  inputs: {
+    name?: string;
+    format: "csv";
+    content_base64: string;
+  }[];
+}
+
+export interface BatchPipelineResponse {
+  // One entry per input, in request order
+  results: {
+    name?: string;
+    output?: {
+      format: "csv";
+      content_base64: string;
+    };
+    error?: string;
+  }[];
+  exec_time_ms: number;
+}
+
 export interface ExportDockerRequest {
   pipeline_version_id: string;
 }
@@ -258,6 +332,7 @@ export interface KeywordsMetadata {
 export interface ValidationResult {
   valid: boolean;
   errors: string[];
+  warnings?: string[]; // accepted, but likely not what was meant
 }
 
 // ============================================
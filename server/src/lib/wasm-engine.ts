@@ -1,4 +1,4 @@
-import type { PipelineSpec, PipelineNode, ParsedCSV, ValidationResult } from "./types";
+import type { PipelineSpec, PipelineNode, ParsedCSV, ValidationResult, ColumnStats } from "./types";
 import { csvToRecords, recordsToCSV } from "./csv";
 
 // ============================================
@@ -148,6 +148,12 @@ function validateNodeConfig(node: PipelineNode): string[] {
       }
       if (!config.expression || typeof config.expression !== "string") {
         errors.push(`Node ${node.id}: transform requires 'expression' string`);
+      } else {
+        try {
+          compileExpression(config.expression);
+        } catch (error) {
+          errors.push(`Node ${node.id}: invalid transform expression: ${(error as Error).message}`);
+        }
       }
       break;
 
@@ -337,31 +343,196 @@ function executeTransform(
   const column = node.config.column as string;
   const expression = node.config.expression as string;
 
+  // Compile once, then evaluate per row
+  const program = tryCompileExpression(expression);
+  if (!program) {
+    console.warn(`Cannot parse transform expression: ${expression}`);
+    return { data, headers };
+  }
+
   const transformed = data.map((row) => {
     const newRow = { ...row };
-    const value = row[column] || "";
-
-    // Simple expression support
-    if (expression === "lower(value)") {
-      newRow[column] = value.toLowerCase();
-    } else if (expression === "upper(value)") {
-      newRow[column] = value.toUpperCase();
-    } else if (expression === "trim(value)") {
-      newRow[column] = value.trim();
-    } else if (expression.startsWith("replace(")) {
-      // replace(value, 'old', 'new')
-      const replaceMatch = expression.match(/replace\(value,\s*'([^']*)',\s*'([^']*)'\)/);
-      if (replaceMatch) {
-        newRow[column] = value.replace(new RegExp(replaceMatch[1], "g"), replaceMatch[2]);
-      }
-    }
-
+    newRow[column] = program(row[column] || "");
     return newRow;
   });
 
   return { data: transformed, headers };
 }
 
+// ============================================
+// Transform Expressions (mirrors engine_wasm/src/expression.cpp)
+// ============================================
+
+type ExprNode =
+  | { kind: "value" }
+  | { kind: "string"; text: string }
+  | { kind: "number"; value: number }
+  | { kind: "call"; name: string; args: ExprNode[] };
+
+function parseExpression(source: string): ExprNode {
+  let pos = 0;
+
+  const fail = (message: string): never => {
+    throw new Error(`${message} at position ${pos} in '${source}'`);
+  };
+  const skipSpace = () => {
+    while (pos < source.length && /\s/.test(source[pos])) pos++;
+  };
+  const accept = (c: string): boolean => {
+    skipSpace();
+    if (source[pos] === c) {
+      pos++;
+      return true;
+    }
+    return false;
+  };
+
+  const parseExpr = (): ExprNode => {
+    skipSpace();
+    if (pos >= source.length) fail("unexpected end of expression");
+    const c = source[pos];
+
+    if (c === "'" || c === '"') {
+      // String literal
+      const close = source.indexOf(c, pos + 1);
+      if (close === -1) fail("unterminated string");
+      const text = source.slice(pos + 1, close);
+      pos = close + 1;
+      return { kind: "string", text };
+    }
+
+    const number = /^-?\d+/.exec(source.slice(pos));
+    if (number) {
+      // Integer literal
+      pos += number[0].length;
+      return { kind: "number", value: parseInt(number[0], 10) };
+    }
+
+    const ident = /^[A-Za-z_]\w*/.exec(source.slice(pos));
+    if (ident) {
+      pos += ident[0].length;
+      if (ident[0] === "value") return { kind: "value" };
+
+      // Function call
+      const args: ExprNode[] = [];
+      if (!accept("(")) fail("expected '('");
+      if (!accept(")")) {
+        do {
+          args.push(parseExpr());
+        } while (accept(","));
+        if (!accept(")")) fail("expected ')'");
+      }
+      return { kind: "call", name: ident[0], args };
+    }
+
+    return fail(`unexpected character '${c}'`);
+  };
+
+  const node = parseExpr();
+  skipSpace();
+  if (pos !== source.length) fail("unexpected trailing input");
+  return node;
+}
+
+const TRIM_START = /^[ \t\r\n]+/;
+const TRIM_END = /[ \t\r\n]+$/;
+
+const UNARY_FUNCTIONS: Record<string, (s: string) => string> = {
+  lower: (s) => s.toLowerCase(),
+  upper: (s) => s.toUpperCase(),
+  trim: (s) => s.replace(TRIM_START, "").replace(TRIM_END, ""),
+  ltrim: (s) => s.replace(TRIM_START, ""),
+  rtrim: (s) => s.replace(TRIM_END, ""),
+  title: (s) => s.toLowerCase().replace(/(^|[^A-Za-z0-9])([a-z])/g, (_, sep, ch) => sep + ch.toUpperCase()),
+  digits: (s) => s.replace(/\D/g, ""),
+};
+
+export function compileExpression(source: string): (value: string) => string {
+  return compileNode(parseExpression(source));
+}
+
+function tryCompileExpression(source: string): ((value: string) => string) | null {
+  try {
+    return compileExpression(source);
+  } catch {
+    return null;
+  }
+}
+
+function compileNode(node: ExprNode): (value: string) => string {
+  if (node.kind === "value") return (value) => value;
+  if (node.kind === "string") return () => node.text;
+  if (node.kind === "number") return () => String(node.value);
+
+  const { name, args } = node;
+  const arity = (min: number, max: number) => {
+    if (args.length < min || args.length > max) {
+      throw new Error(`Wrong number of arguments to ${name}()`);
+    }
+  };
+  const literalString = (arg: ExprNode): string => {
+    if (arg.kind !== "string") throw new Error(`${name}() expects a string literal argument`);
+    return arg.text;
+  };
+  const literalNumber = (arg: ExprNode): number => {
+    if (arg.kind !== "number" || arg.value < 0) {
+      throw new Error(`${name}() expects a non-negative integer literal argument`);
+    }
+    return arg.value;
+  };
+
+  if (name === "concat" || name === "coalesce") {
+    arity(1, 64);
+    const parts = args.map(compileNode);
+    if (name === "concat") return (value) => parts.map((part) => part(value)).join("");
+    return (value) => {
+      for (const part of parts) {
+        const result = part(value);
+        if (result !== "") return result;
+      }
+      return "";
+    };
+  }
+
+  const unary = UNARY_FUNCTIONS[name];
+  if (unary) {
+    arity(1, 1);
+    const inner = compileNode(args[0]);
+    return (value) => unary(inner(value));
+  }
+
+  if (name === "replace") {
+    arity(3, 3);
+    const inner = compileNode(args[0]);
+    const from = literalString(args[1]);
+    const to = literalString(args[2]);
+    return (value) => (from === "" ? inner(value) : inner(value).split(from).join(to));
+  }
+  if (name === "substr") {
+    arity(2, 3);
+    const inner = compileNode(args[0]);
+    const start = literalNumber(args[1]);
+    const length = args.length === 3 ? literalNumber(args[2]) : undefined;
+    return (value) => {
+      const s = inner(value);
+      return length === undefined ? s.slice(start) : s.slice(start, start + length);
+    };
+  }
+  if (name === "left" || name === "right") {
+    arity(2, 2);
+    const inner = compileNode(args[0]);
+    const count = literalNumber(args[1]);
+    return name === "left"
+      ? (value) => inner(value).slice(0, count)
+      : (value) => {
+          const s = inner(value);
+          return s.length > count ? s.slice(s.length - count) : s;
+        };
+  }
+
+  throw new Error(`Unknown function: ${name}()`);
+}
+
 function executeValidateEmail(
   node: PipelineNode,
   data: Record<string, string>[],
@@ -423,3 +594,96 @@ function executeFixDates(
 
   return { data: fixed, headers };
 }
+
+// ============================================
+// Column Statistics (mirrors engine_wasm/src/stats.cpp)
+// ============================================
+
+const INTEGER_PATTERN = /^[+-]?\d+$/;
+// Plain decimal notation, as the C++ engine's column statistics accept
+const NUMBER_PATTERN = /^[+-]?(\d+\.?\d*|\.\d+)([eE][+-]?\d+)?$/;
+const DATE_PATTERN = /^\d{4}-(0[1-9]|1[0-2])-(0[1-9]|[12]\d|3[01])$/;
+const BOOLEAN_VALUES = new Set(["true", "false", "TRUE", "FALSE", "True", "False"]);
+// Integer columns are bounded exactly, as int64; wider values are numbers
+const INT64_MIN = -(2n ** 63n);
+const INT64_MAX = 2n ** 63n - 1n;
+
+// Exact distinct counts stand in for the engine's HyperLogLog estimate
+export function computeColumnStats(csv: ParsedCSV): ColumnStats[] {
+  return csv.headers.map((name, index) => {
+    let nullCount = 0;
+    let isInteger = true;
+    let isNumber = true;
+    let isBoolean = true;
+    let isDate = true;
+    let minNumber = Infinity;
+    let maxNumber = -Infinity;
+    let minInteger: bigint | null = null;
+    let maxInteger: bigint | null = null;
+    let minText: string | null = null;
+    let maxText: string | null = null;
+    const distinct = new Set<string>();
+
+    for (const row of csv.rows) {
+      const cell = row[index] ?? "";
+      if (cell === "") {
+        nullCount++;
+        continue;
+      }
+      distinct.add(cell);
+
+      if (isInteger) {
+        const value = INTEGER_PATTERN.test(cell) ? BigInt(cell) : null;
+        if (value === null || value < INT64_MIN || value > INT64_MAX) {
+          isInteger = false;
+        } else {
+          if (minInteger === null || value < minInteger) minInteger = value;
+          if (maxInteger === null || value > maxInteger) maxInteger = value;
+        }
+      }
+      if (isNumber) {
+        const value = Number(cell);
+        if (!NUMBER_PATTERN.test(cell) || !Number.isFinite(value)) {
+          isNumber = false;
+          isInteger = false;
+        } else {
+          minNumber = Math.min(minNumber, value);
+          maxNumber = Math.max(maxNumber, value);
+        }
+      }
+      if (isBoolean && !BOOLEAN_VALUES.has(cell)) isBoolean = false;
+      if (isDate && !DATE_PATTERN.test(cell)) isDate = false;
+
+      if (minText === null || cell < minText) minText = cell;
+      if (maxText === null || cell > maxText) maxText = cell;
+    }
+
+    const stats: ColumnStats = {
+      name,
+      null_count: nullCount,
+      distinct_estimate: distinct.size,
+      type: "string",
+      min: minText,
+      max: maxText,
+    };
+
+    if (distinct.size === 0) {
+      stats.type = "empty";
+    } else if (isInteger) {
+      // The engine's exact int64 bounds read back from JSON as the nearest double
+      stats.type = "integer";
+      stats.min = Number(minInteger);
+      stats.max = Number(maxInteger);
+    } else if (isNumber) {
+      stats.type = "number";
+      stats.min = minNumber;
+      stats.max = maxNumber;
+    } else if (isBoolean) {
+      stats.type = "boolean";
+    } else if (isDate) {
+      stats.type = "date";
+    }
+
+    return stats;
+  });
+}
@@ -5,13 +5,41 @@ import {
   updateRunStatus,
   updateRunResults,
 } from "../lib/db";
-import { base64Decode, parseCSV, serializeCSV, base64Encode, getCSVHash } from "../lib/csv";
-import { validatePipeline, runPipeline, isWasmLoaded } from "../../engine_wasm/bindings";
+import {
+  decodeCSVBytes,
+  decodeCSVPayload,
+  parseCSV,
+  parseCSVHeader,
+  countCSVRows,
+  serializeCSV,
+  base64Encode,
+  encodeStoredOutput,
+  getCSVHash,
+} from "../lib/csv";
+import {
+  validatePipeline,
+  runPipelineWithStatsAsync,
+  previewPipelineAsync,
+  runPipelineBatchAsync,
+  snapshotInfo,
+  isWasmLoaded,
+} from "../../engine_wasm/bindings";
+import type { EngineInput } from "../../engine_wasm/bindings";
 import { computeMetrics, evaluateRun } from "../lib/eval";
+import { getSnapshot, putSnapshot } from "../lib/snapshot-cache";
 import { ExecutionLogger } from "../lib/logger";
-import type { RerunPipelineRequest, RerunPipelineResponse } from "../lib/types";
+import type {
+  RerunPipelineRequest,
+  RerunPipelineResponse,
+  PreviewPipelineRequest,
+  PreviewPipelineResponse,
+  BatchPipelineRequest,
+  BatchPipelineResponse,
+} from "../lib/types";
 
 const MAX_INPUT_BYTES = parseInt(process.env.MAX_INPUT_BYTES || "10000000", 10); // 10MB default
+const MAX_PREVIEW_ROWS = 1000;
+const MAX_BATCH_INPUTS = parseInt(process.env.MAX_BATCH_INPUTS || "500", 10);
 
 export const pipelineRunRoutes = new Elysia()
   // POST /pipelines/:id/run - Re-run a saved version on new data
@@ -49,7 +77,7 @@ export const pipelineRunRoutes = new Elysia()
       });
 
       // 2. Parse and validate input
-      const csvContent = base64Decode(data.content_base64);
+      const csvContent = decodeCSVPayload(data.content_base64, MAX_INPUT_BYTES);
       const inputBytes = Buffer.byteLength(csvContent, "utf-8");
 
       if (inputBytes > MAX_INPUT_BYTES) {
@@ -57,21 +85,44 @@ export const pipelineRunRoutes = new Elysia()
         throw new Error(`Input too large: ${inputBytes} bytes (max: ${MAX_INPUT_BYTES})`);
       }
 
+      // Re-runs on data the engine has already seen load its columnar
+      // snapshot instead of parsing the CSV again
+      const inputHash = getCSVHash(csvContent);
       const csvParseStart = Date.now();
-      const inputCSV = parseCSV(csvContent);
-      if (inputCSV.headers.length === 0) {
+      const cached = getSnapshot(inputHash);
+      let input: EngineInput;
+      let inputHeaders: string[];
+      let inputRows: number | undefined;
+      let keepSnapshot = false;
+
+      if (cached) {
+        logger.system("Using cached input snapshot", { bytes: cached.length });
+        input = cached;
+        ({ headers: inputHeaders, rows: inputRows } = snapshotInfo(cached));
+      } else if (isWasmLoaded()) {
+        // The engine parses the raw CSV once for this run and returns the
+        // snapshot of what it parsed; the row count comes from its stats
+        input = csvContent;
+        inputHeaders = parseCSVHeader(csvContent);
+        keepSnapshot = true;
+      } else {
+        const parsedCSV = parseCSV(csvContent);
+        input = parsedCSV;
+        inputHeaders = parsedCSV.headers;
+        inputRows = parsedCSV.rows.length;
+      }
+
+      if (inputHeaders.length === 0) {
         logger.systemError("Invalid CSV: no headers found");
         throw new Error("Invalid CSV: no headers found");
       }
 
       logger.systemSuccess("CSV parsed successfully", {
-        rows: inputCSV.rows.length,
-        columns: inputCSV.headers.length,
-        headers: inputCSV.headers.slice(0, 5),
+        rows: inputRows,
+        columns: inputHeaders.length,
+        headers: inputHeaders.slice(0, 5),
       }, Date.now() - csvParseStart);
 
-      const inputHash = getCSVHash(csvContent);
-
       // 3. Create run record
       const run = await createRun(
         pipelineId,
@@ -98,7 +149,7 @@ export const pipelineRunRoutes = new Elysia()
           logger.validatorError("Stored spec validation failed", { errors: validation.errors });
           await updateRunResults(run.id, {
             status: "failed",
-            input_rows: inputCSV.rows.length,
+            input_rows: inputRows ?? countCSVRows(csvContent),
             validation_errors_json: validation.errors,
             logs_json: logger.getLogs(),
           });
@@ -109,6 +160,9 @@ export const pipelineRunRoutes = new Elysia()
         logger.validatorSuccess("Pipeline spec validated", {
           nodes: version.spec_json.nodes.length,
         }, Date.now() - valStart);
+        if (validation.warnings?.length) {
+          logger.validatorWarn("Pipeline spec has warnings", { warnings: validation.warnings });
+        }
 
         // 5. Execute pipeline
         await updateRunStatus(run.id, "running");
@@ -124,18 +178,24 @@ export const pipelineRunRoutes = new Elysia()
           });
         }
 
-        const outputCSV = runPipeline(version.spec_json, inputCSV);
+        const { output: outputCSV, stats, snapshot } = await runPipelineWithStatsAsync(version.spec_json, input, {
+          snapshot: keepSnapshot,
+        });
+        if (snapshot) {
+          putSnapshot(inputHash, snapshot);
+        }
+        inputRows = stats.input_rows;
 
         logger.executorSuccess("Pipeline execution completed", {
-          input_rows: inputCSV.rows.length,
+          input_rows: inputRows,
           output_rows: outputCSV.rows.length,
-          rows_removed: inputCSV.rows.length - outputCSV.rows.length,
+          rows_removed: inputRows - outputCSV.rows.length,
         }, Date.now() - execStart);
 
         // 6. Compute metrics and evaluation
         const execTimeMs = Date.now() - startTime;
-        const metrics = computeMetrics(inputCSV, outputCSV, execTimeMs);
-        const evalResult = evaluateRun(version.spec_json, inputCSV, outputCSV, []);
+        const metrics = computeMetrics(inputRows, outputCSV, execTimeMs, stats);
+        const evalResult = evaluateRun(version.spec_json, inputRows, outputCSV, [], stats);
 
         logger.system("Metrics and evaluation computed", {
           exec_time_ms: execTimeMs,
@@ -152,9 +212,9 @@ export const pipelineRunRoutes = new Elysia()
         // 8. Persist results
         await updateRunResults(run.id, {
           status: "success",
-          input_rows: inputCSV.rows.length,
+          input_rows: inputRows,
           output_rows: outputCSV.rows.length,
-          output_base64: outputBase64,
+          output_base64: encodeStoredOutput(outputContent),
           fix_iterations: 0,
           exec_time_ms: execTimeMs,
           metrics_json: metrics,
@@ -188,7 +248,7 @@ export const pipelineRunRoutes = new Elysia()
 
         await updateRunResults(run.id, {
           status: "failed",
-          input_rows: inputCSV.rows.length,
+          input_rows: inputRows ?? countCSVRows(csvContent),
           validation_errors_json: [(error as Error).message],
           logs_json: logger.getLogs(),
         });
@@ -210,4 +270,125 @@ export const pipelineRunRoutes = new Elysia()
         ),
       }),
     }
+  )
+  // POST /pipelines/:id/preview - First (or sampled) output rows of a saved
+  // version on new data. Nothing is recorded; the engine stops parsing the
+  // upload once the preview is full.
+  .post(
+    "/pipelines/:id/preview",
+    async ({ params, body }): Promise<PreviewPipelineResponse> => {
+      const startTime = Date.now();
+      const { id: pipelineId } = params;
+      const { pipeline_version_id, data, options } = body as PreviewPipelineRequest;
+
+      const version = await getPipelineVersion(pipeline_version_id);
+      if (!version) {
+        throw new Error(`Pipeline version not found: ${pipeline_version_id}`);
+      }
+      if (version.pipeline_id !== pipelineId) {
+        throw new Error(`Version ${pipeline_version_id} does not belong to pipeline ${pipelineId}`);
+      }
+      if (!version.spec_json) {
+        throw new Error(`Pipeline version ${pipeline_version_id} has no spec`);
+      }
+
+      const validation = validatePipeline(version.spec_json);
+      if (!validation.valid) {
+        throw new Error(`Stored spec invalid: ${validation.errors.join(", ")}`);
+      }
+
+      // Hand the engine the raw bytes; it parses only what the preview needs
+      const input = decodeCSVBytes(data.content_base64, MAX_INPUT_BYTES);
+      if (input.length > MAX_INPUT_BYTES) {
+        throw new Error(`Input too large: ${input.length} bytes (max: ${MAX_INPUT_BYTES})`);
+      }
+
+      const output = await previewPipelineAsync(version.spec_json, input, {
+        ...options,
+        limit: Math.min(options?.limit ?? 100, MAX_PREVIEW_ROWS),
+      });
+
+      return { output, exec_time_ms: Date.now() - startTime };
+    },
+    {
+      body: t.Object({
+        pipeline_version_id: t.String(),
+        data: t.Object({
+          format: t.Literal("csv"),
+          content_base64: t.String(),
+        }),
+        options: t.Optional(
+          t.Object({
+            limit: t.Optional(t.Number({ minimum: 1 })),
+            mode: t.Optional(t.Union([t.Literal("head"), t.Literal("sample")])),
+            seed: t.Optional(t.Number()),
+          })
+        ),
+      }),
+    }
+  )
+  // POST /pipelines/:id/batch - Run a saved version over many inputs (e.g.
+  // the nightly per-customer files) in one engine call. The spec is
+  // compiled once for the whole batch; failures are reported per input.
+  // Nothing is recorded.
+  .post(
+    "/pipelines/:id/batch",
+    async ({ params, body }): Promise<BatchPipelineResponse> => {
+      const startTime = Date.now();
+      const { id: pipelineId } = params;
+      const { pipeline_version_id, inputs } = body as BatchPipelineRequest;
+
+      const version = await getPipelineVersion(pipeline_version_id);
+      if (!version) {
+        throw new Error(`Pipeline version not found: ${pipeline_version_id}`);
+      }
+      if (version.pipeline_id !== pipelineId) {
+        throw new Error(`Version ${pipeline_version_id} does not belong to pipeline ${pipelineId}`);
+      }
+      if (!version.spec_json) {
+        throw new Error(`Pipeline version ${pipeline_version_id} has no spec`);
+      }
+
+      const validation = validatePipeline(version.spec_json);
+      if (!validation.valid) {
+        throw new Error(`Stored spec invalid: ${validation.errors.join(", ")}`);
+      }
+
+      if (inputs.length > MAX_BATCH_INPUTS) {
+        throw new Error(`Too many inputs: ${inputs.length} (max: ${MAX_BATCH_INPUTS})`);
+      }
+
+      // The engine takes the raw bytes of each input
+      const inputBytes = inputs.map((input, i) => {
+        const bytes = decodeCSVBytes(input.content_base64, MAX_INPUT_BYTES);
+        if (bytes.length > MAX_INPUT_BYTES) {
+          throw new Error(`Input ${input.name ?? i + 1} too large: ${bytes.length} bytes (max: ${MAX_INPUT_BYTES})`);
+        }
+        return bytes;
+      });
+
+      const results = await runPipelineBatchAsync(version.spec_json, inputBytes);
+
+      return {
+        results: results.map((result, i) => ({
+          name: inputs[i].name,
+          ...("output" in result
+            ? { output: { format: "csv" as const, content_base64: base64Encode(result.output) } }
+            : { error: result.error }),
+        })),
+        exec_time_ms: Date.now() - startTime,
+      };
+    },
+    {
+      body: t.Object({
+        pipeline_version_id: t.String(),
+        inputs: t.Array(
+          t.Object({
+            name: t.Optional(t.String()),
+            format: t.Literal("csv"),
+            content_base64: t.String(),
+          })
+        ),
+      }),
+    }
   );
@@ -8,8 +8,8 @@ import {
   updateRunStatus,
 } from "../lib/db";
 import { generatePipelineSpec, repairPipelineSpec } from "../lib/keywords";
-import { base64Decode, parseCSV, serializeCSV, base64Encode, getCSVHash } from "../lib/csv";
-import { validatePipeline, runPipeline, isWasmLoaded } from "../../engine_wasm/bindings";
+import { decodeCSVPayload, parseCSV, serializeCSV, base64Encode, encodeStoredOutput, getCSVHash } from "../lib/csv";
+import { validatePipeline, runPipelineWithStatsAsync, isWasmLoaded } from "../../engine_wasm/bindings";
 import { computeMetrics, evaluateRun } from "../lib/eval";
 import { ExecutionLogger } from "../lib/logger";
 import type { CreatePipelineRequest, CreatePipelineResponse, PipelineSpec } from "../lib/types";
@@ -28,8 +28,8 @@ export const runRoutes = new Elysia().post(
     
     logger.system("Pipeline execution started", { prompt_length: prompt.length });
 
-    // Decode base64 input
-    const csvContent = base64Decode(data.content_base64);
+    // Decode base64 input (gzip uploads are inflated)
+    const csvContent = decodeCSVPayload(data.content_base64, MAX_INPUT_BYTES);
     const inputBytes = Buffer.byteLength(csvContent, "utf-8");
 
     // Check size limit
@@ -122,6 +122,9 @@ export const runRoutes = new Elysia().post(
           logger.validatorSuccess("Pipeline spec validated successfully", {
             nodes: currentSpec.nodes.length,
           }, Date.now() - valStart);
+          if (validation.warnings?.length) {
+            logger.validatorWarn("Pipeline spec has warnings", { warnings: validation.warnings });
+          }
           break;
         }
 
@@ -194,7 +197,12 @@ export const runRoutes = new Elysia().post(
         });
       }
 
-      const outputCSV = runPipeline(currentSpec, inputCSV);
+      // The engine parses the raw upload itself; only the TS fallback
+      // reuses the rows parsed above
+      const { output: outputCSV, stats } = await runPipelineWithStatsAsync(
+        currentSpec,
+        isWasmLoaded() ? csvContent : inputCSV
+      );
       
       logger.executorSuccess("Pipeline execution completed", {
         input_rows: inputCSV.rows.length,
@@ -204,8 +212,8 @@ export const runRoutes = new Elysia().post(
 
       // 7. Compute metrics and evaluation
       const execTimeMs = Date.now() - startTime;
-      const metrics = computeMetrics(inputCSV, outputCSV, execTimeMs);
-      const evalResult = evaluateRun(currentSpec, inputCSV, outputCSV, validationErrors);
+      const metrics = computeMetrics(inputCSV.rows.length, outputCSV, execTimeMs, stats);
+      const evalResult = evaluateRun(currentSpec, inputCSV.rows.length, outputCSV, validationErrors, stats);
       
       logger.system("Metrics and evaluation computed", {
         exec_time_ms: execTimeMs,
@@ -226,7 +234,7 @@ export const runRoutes = new Elysia().post(
         status: "success",
         input_rows: inputCSV.rows.length,
         output_rows: outputCSV.rows.length,
-        output_base64: outputBase64,
+        output_base64: encodeStoredOutput(outputContent),
         fix_iterations: fixIterations,
         exec_time_ms: execTimeMs,
         metrics_json: metrics,
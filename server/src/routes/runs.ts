@@ -1,5 +1,6 @@
 import { Elysia } from "elysia";
 import { getRun } from "../lib/db";
+import { decodeStoredOutput } from "../lib/csv";
 import type { RunDetailResponse } from "../lib/types";
 
 export const runsRoutes = new Elysia()
@@ -25,7 +26,7 @@ export const runsRoutes = new Elysia()
       keywords_trace_id: run.keywords_trace_id,
       created_at: run.created_at,
       finished_at: run.finished_at,
-      output_base64: run.output_base64,
+      output_base64: run.output_base64 && decodeStoredOutput(run.output_base64),
       validation_errors: run.validation_errors_json,
       metrics: run.metrics_json,
       logs: run.logs_json,